@@ -0,0 +1,131 @@
+#include "CommandRegistry.h"
+
+namespace
+{
+    // "12" -> 12, false for anything else (9 digits at most, no overflow)
+    bool parseUnsigned(const char *s, uint32_t &out)
+    {
+        uint32_t value = 0;
+        uint8_t digits = 0;
+        for (; *s; s++)
+        {
+            if (*s < '0' || *s > '9' || ++digits > 9)
+                return false;
+            value = value * 10 + (*s - '0');
+        }
+        out = value;
+        return digits > 0;
+    }
+}
+
+const CommandSpec *CommandRegistry::find(const char *action) const
+{
+    uint32_t hash = commandHash(action);
+    for (uint8_t i = 0; i < count; i++)
+    {
+        // the name check guards against a hash collision with an unknown action
+        if (table[i].hash == hash && strcmp(table[i].name, action) == 0)
+            return &table[i];
+    }
+    return nullptr;
+}
+
+bool CommandRegistry::readArg(const CommandSpec &spec, JsonVariantConst value, CommandArg &arg)
+{
+    switch (spec.arg)
+    {
+    case CMD_ARG_NONE:
+        return true;
+
+    case CMD_ARG_UINT:
+        if (value.is<uint32_t>())
+            arg.num = value.as<uint32_t>();
+        else if (!value.is<const char *>() || !parseUnsigned(value.as<const char *>(), arg.num))
+            return false;
+        return arg.num >= spec.min && arg.num <= spec.max;
+
+    case CMD_ARG_STRING:
+    {
+        if (!value.is<const char *>())
+            return false;
+        arg.str = value.as<const char *>();
+        size_t len = strlen(arg.str);
+        return len > 0 && len <= spec.max;
+    }
+    }
+    return false;
+}
+
+CommandStatus CommandRegistry::run(JsonVariantConst command, JsonObject result) const
+{
+    const char *action = command["action"];
+    CommandArg arg = {nullptr, 0, command["id"].as<const char *>(), command["unit"].as<const char *>()};
+
+    if (!command["id"].isNull())
+        result["id"] = command["id"];
+    result["action"] = action;
+
+    const CommandSpec *spec = action ? find(action) : nullptr;
+    if (!spec)
+        return CMD_UNKNOWN;
+
+    if (!readArg(*spec, command["value"], arg))
+        return CMD_BAD_ARG;
+
+    return spec->handler(arg, result);
+}
+
+DeserializationError CommandRegistry::parse(JsonDocument &doc, const uint8_t *payload, size_t length)
+{
+    // const input: ArduinoJson copies the strings instead of linking them
+    return deserializeJson(doc, (const char *)payload, length);
+}
+
+void CommandRegistry::dispatch(JsonVariantConst message, JsonArray results) const
+{
+    JsonArrayConst commands = message["commands"];
+    if (commands.isNull())
+    {
+        JsonObject result = results.createNestedObject();
+        result["status"] = statusName(run(message, result));
+        return;
+    }
+
+    uint8_t n = 0;
+    for (JsonVariantConst command : commands)
+    {
+        JsonObject result = results.createNestedObject();
+        CommandStatus status = CMD_SKIPPED;
+        if (n++ < MAX_BATCH)
+        {
+            status = run(command, result);
+        }
+        else
+        {
+            if (!command["id"].isNull())
+                result["id"] = command["id"];
+            result["action"] = command["action"];
+        }
+        result["status"] = statusName(status);
+    }
+}
+
+const char *CommandRegistry::statusName(CommandStatus status)
+{
+    switch (status)
+    {
+    case CMD_OK:
+        return "ok";
+    case CMD_ACCEPTED:
+        return "accepted";
+    case CMD_UNKNOWN:
+        return "unknown";
+    case CMD_BAD_ARG:
+        return "bad_arg";
+    case CMD_FAILED:
+        return "failed";
+    case CMD_SKIPPED:
+        return "skipped";
+    }
+    return "unknown";
+}
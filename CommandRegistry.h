@@ -0,0 +1,103 @@
+#ifndef COMMAND_REGISTRY_H
+#define COMMAND_REGISTRY_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// FNV-1a, evaluated at compile time for the command table
+constexpr uint32_t commandHash(const char *name)
+{
+    uint32_t hash = 2166136261u;
+    while (*name)
+        hash = (hash ^ (uint8_t)*name++) * 16777619u;
+    return hash;
+}
+
+enum CommandArgType : uint8_t
+{
+    CMD_ARG_NONE = 0,
+    CMD_ARG_UINT,   // JSON number or numeric string, min..max
+    CMD_ARG_STRING, // 1..max chars
+};
+
+enum CommandStatus : uint8_t
+{
+    CMD_OK = 0,
+    CMD_ACCEPTED, // started, the outcome is published later (uart_send)
+    CMD_UNKNOWN,  // no such action
+    CMD_BAD_ARG,  // value missing, wrong type or out of range
+    CMD_FAILED,   // the handler could not do it
+    CMD_SKIPPED,  // not run, the batch is over MAX_BATCH
+};
+
+struct CommandArg
+{
+    const char *str;  // CMD_ARG_STRING
+    uint32_t num;     // CMD_ARG_UINT
+    const char *id;   // correlation id if it is a string, may be nullptr
+    const char *unit; // "unit" of a multi-channel bridge, may be nullptr
+};
+
+typedef CommandStatus (*CommandHandler)(const CommandArg &arg, JsonObject result);
+
+struct CommandSpec
+{
+    constexpr CommandSpec(const char *name, CommandArgType arg, uint32_t min, uint32_t max, CommandHandler handler)
+        : name(name), hash(commandHash(name)), arg(arg), min(min), max(max), handler(handler) {}
+
+    const char *name;
+    uint32_t hash;
+    CommandArgType arg;
+    uint32_t min; // CMD_ARG_UINT: smallest value, CMD_ARG_STRING: unused
+    uint32_t max; // CMD_ARG_UINT: largest value, CMD_ARG_STRING: longest string
+    CommandHandler handler;
+};
+
+// static_assert(commandHashesUnique(COMMANDS, n), ...) on the table
+constexpr bool commandHashesUnique(const CommandSpec *table, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        for (size_t j = i + 1; j < count; j++)
+        {
+            if (table[i].hash == table[j].hash)
+                return false;
+        }
+    }
+    return true;
+}
+
+// Table-driven MQTT commands. A message holds one command
+//   {"action":"blink","value":3,"id":"a1","receiver":"<client_id>"}
+// or several, run in order:
+//   {"receiver":"<client_id>","commands":[{"action":...,"id":...}, ...]}
+// Every command gets a result {"id","action","status"[,"error"]} in the
+// reply, the action name is looked up by its hash, the value is checked
+// against the spec before the handler runs.
+class CommandRegistry
+{
+public:
+    static const uint8_t MAX_BATCH = 8;
+
+    CommandRegistry(const CommandSpec *table, uint8_t count) : table(table), count(count) {}
+
+    // parses a message into doc with its strings copied: a handler may
+    // publish, which reuses the buffer the payload arrived in
+    static DeserializationError parse(JsonDocument &doc, const uint8_t *payload, size_t length);
+
+    // runs the command(s) of a parsed message, appends one entry per command to results
+    void dispatch(JsonVariantConst message, JsonArray results) const;
+
+    const CommandSpec *find(const char *action) const;
+
+    static const char *statusName(CommandStatus status);
+
+private:
+    const CommandSpec *table;
+    uint8_t count;
+
+    CommandStatus run(JsonVariantConst command, JsonObject result) const;
+    static bool readArg(const CommandSpec &spec, JsonVariantConst value, CommandArg &arg);
+};
+
+#endif // COMMAND_REGISTRY_H
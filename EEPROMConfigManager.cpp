@@ -3,25 +3,145 @@
 void EEPROMConfigManager::begin()
 {
     EEPROM.begin(EEPROM_SIZE);
+
+    const ConfigRecord *a = validSlot(OFFSET_SLOT_A);
+    const ConfigRecord *b = validSlot(OFFSET_SLOT_B);
+
+    if (a && (!b || (int32_t)(a->sequence - b->sequence) > 0))
+    {
+        loadFrom(*a);
+        _loadedSlot = 'A';
+    }
+    else if (b)
+    {
+        loadFrom(*b);
+        _loadedSlot = 'B';
+    }
+    else if (recordSeen())
+    {
+        // both slots damaged (power cut while the sector was rewritten):
+        // defaults, the legacy layout is older than any record
+        setDefaults();
+        eraseLegacy();
+        _loadedSlot = 0;
+        commit();
+    }
+    else
+    {
+        // first boot with this firmware (a torn migration commit leaves no
+        // record, so it is migrated again)
+        migrateLegacy();
+        _loadedSlot = 0;
+        commit();
+    }
+}
+
+// a record header (valid or not) means the legacy layout was migrated
+bool EEPROMConfigManager::recordSeen()
+{
+    const uint8_t *data = EEPROM.getConstDataPtr();
+    return ((const ConfigRecord *)(data + OFFSET_SLOT_A))->magic == CONFIG_MAGIC ||
+           ((const ConfigRecord *)(data + OFFSET_SLOT_B))->magic == CONFIG_MAGIC;
+}
+
+// erased by the first commit after the migration; the legacy area is written
+// before the slots, so a commit torn in a slot cannot bring it back
+void EEPROMConfigManager::eraseLegacy()
+{
+    for (int addr = 0; addr < OFFSET_SLOT_A; addr++)
+    {
+        if (EEPROM.read(addr) != 0xFF)
+            EEPROM.write(addr, 0xFF);
+    }
 }
 
-void EEPROMConfigManager::saveStringToEEPROM(int addr, const char *value)
+// checked in place, in the EEPROM RAM cache
+const ConfigRecord *EEPROMConfigManager::validSlot(int addr)
 {
-    int i = 0;
-    while (value[i] && i < MAX_VALUE_LEN)
+    const ConfigRecord *slot = (const ConfigRecord *)(EEPROM.getConstDataPtr() + addr);
+
+    if (slot->magic != CONFIG_MAGIC || slot->version == 0 || slot->version > CONFIG_VERSION ||
+        slot->length < CONFIG_HEADER_SIZE || slot->length > sizeof(ConfigRecord))
+    {
+        return nullptr;
+    }
+
+    const uint8_t *payload = (const uint8_t *)slot + CONFIG_HEADER_SIZE;
+    if (crc32(payload, slot->length - CONFIG_HEADER_SIZE) != slot->crc)
     {
-        EEPROM.write(addr + i, value[i]);
-        i++;
+        return nullptr;
     }
-    EEPROM.write(addr + i, '\0');
-    EEPROM.commit();
+    return slot;
+}
+
+void EEPROMConfigManager::loadFrom(const ConfigRecord &slot)
+{
+    // an older, shorter record keeps defaults for the fields added later
+    setDefaults();
+    memcpy(&record, &slot, slot.length);
+}
+
+bool EEPROMConfigManager::commit()
+{
+    record.magic = CONFIG_MAGIC;
+    record.version = CONFIG_VERSION;
+    record.length = sizeof(ConfigRecord);
+    record.sequence++;
+    record.crc = crc32((const uint8_t *)&record + CONFIG_HEADER_SIZE,
+                       sizeof(ConfigRecord) - CONFIG_HEADER_SIZE);
+
+    // never overwrite the record we booted from
+    char slot = _loadedSlot == 'A' ? 'B' : 'A';
+    if (_loadedSlot)
+        eraseLegacy();
+    EEPROM.put(slot == 'A' ? OFFSET_SLOT_A : OFFSET_SLOT_B, record);
+    if (!EEPROM.commit())
+    {
+        return false;
+    }
+    _loadedSlot = slot;
+    return true;
+}
+
+void EEPROMConfigManager::setDefaults()
+{
+    memset(&record, 0, sizeof(record));
+    record.mqttPort = 1883;
+    record.publishPolicy = DEFAULT_PUBLISH_POLICY;
+    record.telemetryEncoding = DEFAULT_TELEMETRY_ENCODING;
+}
+
+void EEPROMConfigManager::migrateLegacy()
+{
+    setDefaults();
+
+    readStringFromEEPROM(OFFSET_WIFI_SSID, record.wifiSsid, MAX_LEN_WIFI_SSID);
+    readStringFromEEPROM(OFFSET_WIFI_PASS, record.wifiPass, MAX_LEN_WIFI_PASSWORD);
+    readStringFromEEPROM(OFFSET_MQTT_SERVER, record.mqttServer, MAX_LEN_MQTT_SERVER);
+
+    char portStr[6] = {0};
+    readStringFromEEPROM(OFFSET_MQTT_PORT, portStr, sizeof(portStr));
+    if (atoi(portStr) > 0)
+        record.mqttPort = atoi(portStr);
+
+    readStringFromEEPROM(OFFSET_MQTT_USER, record.mqttUser, MAX_LEN_MQTT_USER);
+    readStringFromEEPROM(OFFSET_MQTT_PASS, record.mqttPass, MAX_LEN_MQTT_PASSW);
+    readStringFromEEPROM(OFFSET_MQTT_CLIENT_ID, record.mqttClientId, MAX_LEN_MQTT_CLIENT_ID);
+    readStringFromEEPROM(OFFSET_AUTH_USER, record.authUser, MAX_LEN_AUTH_USER);
+    readStringFromEEPROM(OFFSET_AUTH_PASS, record.authPass, MAX_LEN_AUTH_PASSW);
+
+    if (EEPROM.read(OFFSET_PUBLISH_POLICY) == PUBLISH_POLICY_MARKER)
+        EEPROM.get(OFFSET_PUBLISH_POLICY + 1, record.publishPolicy);
+    if (EEPROM.read(OFFSET_TELEMETRY_ENCODING) == PUBLISH_POLICY_MARKER)
+        record.telemetryEncoding = EEPROM.read(OFFSET_TELEMETRY_ENCODING + 1);
 }
 
 void EEPROMConfigManager::readStringFromEEPROM(int addr, char *buffer, size_t maxLen)
 {
-    int i = 0;
+    size_t i = 0;
     char c;
-    while ((c = EEPROM.read(addr + i)) != '\0' && i < maxLen - 1)
+    // 0xFF is erased flash, not a character
+    while ((c = EEPROM.read(addr + i)) != '\0' && (uint8_t)c != 0xFF && i < maxLen - 1)
     {
         buffer[i++] = c;
     }
@@ -30,72 +150,106 @@ void EEPROMConfigManager::readStringFromEEPROM(int addr, char *buffer, size_t ma
 
 void EEPROMConfigManager::saveWiFiConfig(const char *ssid, const char *pass)
 {
-    saveStringToEEPROM(OFFSET_WIFI_SSID, ssid);
-    saveStringToEEPROM(OFFSET_WIFI_PASS, pass);
+    strlcpy(record.wifiSsid, ssid, sizeof(record.wifiSsid));
+    strlcpy(record.wifiPass, pass, sizeof(record.wifiPass));
+    memset(&record.wifiJoinCache, 0, sizeof(record.wifiJoinCache));
 }
 
 void EEPROMConfigManager::loadWiFiConfig(char *ssid, char *pass)
 {
-    readStringFromEEPROM(OFFSET_WIFI_SSID, ssid, MAX_LEN_WIFI_SSID);
-    readStringFromEEPROM(OFFSET_WIFI_PASS, pass, MAX_LEN_WIFI_PASSWORD);
+    strlcpy(ssid, record.wifiSsid, MAX_LEN_WIFI_SSID + 1);
+    strlcpy(pass, record.wifiPass, MAX_LEN_WIFI_PASSWORD + 1);
+}
+
+void EEPROMConfigManager::saveWiFiJoinCache(const WiFiJoinCache &cache)
+{
+    record.wifiJoinCache = cache;
+}
+
+bool EEPROMConfigManager::loadWiFiJoinCache(WiFiJoinCache &cache)
+{
+    cache = record.wifiJoinCache;
+    return cache.channel != 0;
 }
 
 void EEPROMConfigManager::saveMQTTConfig(const char *server, uint16_t port,
                                          const char *user, const char *pass,
                                          const char *clientId)
 {
-    saveStringToEEPROM(OFFSET_MQTT_SERVER, server);
-
-    char portStr[6];
-    snprintf(portStr, sizeof(portStr), "%u", port);
-    saveStringToEEPROM(OFFSET_MQTT_PORT, portStr);
-
-    saveStringToEEPROM(OFFSET_MQTT_USER, user);
-    saveStringToEEPROM(OFFSET_MQTT_PASS, pass);
-    saveStringToEEPROM(OFFSET_MQTT_CLIENT_ID, clientId);
+    strlcpy(record.mqttServer, server, sizeof(record.mqttServer));
+    record.mqttPort = port;
+    strlcpy(record.mqttUser, user, sizeof(record.mqttUser));
+    strlcpy(record.mqttPass, pass, sizeof(record.mqttPass));
+    strlcpy(record.mqttClientId, clientId, sizeof(record.mqttClientId));
 }
 
 void EEPROMConfigManager::loadMQTTConfig(char *server, uint16_t *port,
                                          char *user, char *pass,
                                          char *clientId)
 {
-    readStringFromEEPROM(OFFSET_MQTT_SERVER, server, MAX_LEN_MQTT_SERVER);
-
-    char portStr[6] = {0};
-    readStringFromEEPROM(OFFSET_MQTT_PORT, portStr, sizeof(portStr));
+    strlcpy(server, record.mqttServer, MAX_LEN_MQTT_SERVER + 1);
     if (port)
-        *port = atoi(portStr);
-
-    readStringFromEEPROM(OFFSET_MQTT_USER, user, MAX_LEN_MQTT_USER);
-    readStringFromEEPROM(OFFSET_MQTT_PASS, pass, MAX_LEN_MQTT_PASSW);
-    readStringFromEEPROM(OFFSET_MQTT_CLIENT_ID, clientId, MAX_LEN_MQTT_CLIENT_ID);
+        *port = record.mqttPort;
+    strlcpy(user, record.mqttUser, MAX_LEN_MQTT_USER + 1);
+    strlcpy(pass, record.mqttPass, MAX_LEN_MQTT_PASSW + 1);
+    strlcpy(clientId, record.mqttClientId, MAX_LEN_MQTT_CLIENT_ID + 1);
 }
 
 void EEPROMConfigManager::saveAuth(const char *user, const char *pass)
 {
     if (user && strlen(user) > 0 && isAscii(user[0]))
     {
-        saveStringToEEPROM(OFFSET_AUTH_USER, user);
+        strlcpy(record.authUser, user, sizeof(record.authUser));
     }
 
     if (pass && strlen(pass) > 0 && isAscii(pass[0]))
     {
-        saveStringToEEPROM(OFFSET_AUTH_PASS, pass);
+        strlcpy(record.authPass, pass, sizeof(record.authPass));
     }
 }
 
 void EEPROMConfigManager::loadAuth(char *user, char *pass)
 {
-    readStringFromEEPROM(OFFSET_AUTH_USER, user, MAX_LEN_AUTH_USER);
-    readStringFromEEPROM(OFFSET_AUTH_PASS, pass, MAX_LEN_AUTH_PASSW);
+    strlcpy(user, record.authUser, MAX_LEN_AUTH_USER);
+    strlcpy(pass, record.authPass, MAX_LEN_AUTH_PASSW);
+}
+
+void EEPROMConfigManager::savePublishPolicy(const PublishPolicyConfig &cfg)
+{
+    record.publishPolicy = cfg;
+}
+
+void EEPROMConfigManager::loadPublishPolicy(PublishPolicyConfig &cfg)
+{
+    cfg = record.publishPolicy;
+}
+
+void EEPROMConfigManager::saveTelemetryEncoding(uint8_t mask)
+{
+    record.telemetryEncoding = mask;
+}
+
+uint8_t EEPROMConfigManager::loadTelemetryEncoding()
+{
+    return record.telemetryEncoding;
 }
 
 void EEPROMConfigManager::resetWiFiCredentials()
 {
+    memset(record.wifiSsid, 0, sizeof(record.wifiSsid));
+    memset(record.wifiPass, 0, sizeof(record.wifiPass));
+    memset(&record.wifiJoinCache, 0, sizeof(record.wifiJoinCache));
+    commit();
+}
 
-    for (int i = OFFSET_WIFI_SSID; i < OFFSET_WIFI_PASS + 64; i++)
+uint32_t EEPROMConfigManager::crc32(const uint8_t *data, size_t len)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    while (len--)
     {
-        EEPROM.write(i, 0); // Обнуляем байты
+        crc ^= *data++;
+        for (uint8_t k = 0; k < 8; ++k)
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
     }
-    EEPROM.commit();
-}
\ No newline at end of file
+    return ~crc;
+}
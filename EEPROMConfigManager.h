@@ -1,11 +1,67 @@
 #pragma once
 #include <Arduino.h>
 #include <EEPROM.h>
+#include <stddef.h>
+#include "PublishPolicy.h"
+#include "TelemetryEncoding.h"
+
+// Last good Wi-Fi join, used for a direct (no scan) join at boot
+struct WiFiJoinCache
+{
+    uint8_t bssid[6];
+    uint8_t channel; // 0 = nothing cached
+    uint8_t reserved;
+    uint32_t ip; // DHCP lease, reused only with FAST_BOOT_STATIC_IP
+    uint32_t gateway;
+    uint32_t subnet;
+    uint32_t dns;
+};
+
+// Whole device config, stored as one CRC-protected record
+struct ConfigRecord
+{
+    // header
+    uint32_t magic;
+    uint16_t version;
+    uint16_t length;   // sizeof(ConfigRecord) when written
+    uint32_t sequence; // newer record wins, see EEPROMConfigManager::begin
+    uint32_t crc;      // CRC32 of the bytes after the header, up to `length`
+
+    // payload (only append new fields, bump CONFIG_VERSION)
+    char wifiSsid[64];
+    char wifiPass[64];
+    char mqttServer[64];
+    uint16_t mqttPort;
+    char mqttUser[64];
+    char mqttPass[64];
+    char mqttClientId[64];
+    char authUser[32];
+    char authPass[32];
+    PublishPolicyConfig publishPolicy;
+    uint8_t telemetryEncoding;
+    // version 2
+    WiFiJoinCache wifiJoinCache;
+};
 
 class EEPROMConfigManager
 {
 public:
-    static const int EEPROM_SIZE = 512;
+    static const uint32_t CONFIG_MAGIC = 0x58594346; // "XYCF"
+    static const uint16_t CONFIG_VERSION = 2;
+    static const int CONFIG_HEADER_SIZE = offsetof(ConfigRecord, wifiSsid);
+
+    // A/B slots: commit() always writes the slot not holding the current record,
+    // so a torn record write leaves the previous record intact. Both slots are
+    // in the one flash sector of the emulated EEPROM, which commit() erases and
+    // rewrites as a whole: a power cut during the erase or before slot A is
+    // rewritten can damage both. That is detected (CRC) and the defaults are
+    // loaded, never a half-written or legacy config.
+    static const int SLOT_SIZE = 1024;
+    static const int OFFSET_SLOT_A = 1024;
+    static const int OFFSET_SLOT_B = 2048;
+    static const int EEPROM_SIZE = 3072;
+
+    // Legacy layout (one string per offset), only read to migrate old devices
     static const int OFFSET_WIFI_SSID = 0;
     static const int OFFSET_WIFI_PASS = 64;
     static const int OFFSET_MQTT_SERVER = 128;
@@ -15,6 +71,10 @@ public:
     static const int OFFSET_MQTT_CLIENT_ID = 328;
     static const int OFFSET_AUTH_USER = 448;
     static const int OFFSET_AUTH_PASS = 480;
+    static const int OFFSET_PUBLISH_POLICY = 512;     // 1 byte marker + PublishPolicyConfig
+    static const int OFFSET_TELEMETRY_ENCODING = 560; // 1 byte marker + encoding mask
+
+    static const uint8_t PUBLISH_POLICY_MARKER = 0xA6;
 
     static const int MAX_VALUE_LEN = 63; // Change it If you want values lenght more then 63
 
@@ -29,15 +89,26 @@ public:
     static const int MAX_LEN_AUTH_USER = 32;
     static const int MAX_LEN_AUTH_PASSW = 32;
 
+    // loads the newest valid slot; migrates the legacy layout if no record
+    // was ever written (it is erased by the next commit), defaults if the
+    // records are damaged
     void
     begin();
 
-    void saveStringToEEPROM(int addr, const char *value);
-    void readStringFromEEPROM(int addr, char *buffer, size_t maxLen);
+    // writes everything saved since the last commit with one EEPROM.commit()
+    bool commit();
 
+    // 'A', 'B', or 0 if the config came from defaults / migration
+    char loadedSlot() const { return _loadedSlot; }
+
+    // new credentials also drop the join cache
     void saveWiFiConfig(const char *ssid, const char *pass);
     void loadWiFiConfig(char *ssid, char *pass);
 
+    void saveWiFiJoinCache(const WiFiJoinCache &cache);
+    // false if there is no cached join
+    bool loadWiFiJoinCache(WiFiJoinCache &cache);
+
     void saveMQTTConfig(const char *server, uint16_t port,
                         const char *user, const char *pass,
                         const char *clientId);
@@ -49,5 +120,30 @@ public:
     void saveAuth(const char *user, const char *pass);
     void loadAuth(char *user, char *pass);
 
+    void savePublishPolicy(const PublishPolicyConfig &cfg);
+    void loadPublishPolicy(PublishPolicyConfig &cfg);
+
+    void saveTelemetryEncoding(uint8_t mask);
+    uint8_t loadTelemetryEncoding();
+
+    // clears and commits the Wi-Fi credentials
     void resetWiFiCredentials();
-};
\ No newline at end of file
+
+private:
+    ConfigRecord record;
+    char _loadedSlot = 0;
+
+    static_assert(sizeof(ConfigRecord) <= SLOT_SIZE, "ConfigRecord does not fit in a slot");
+    static_assert(OFFSET_SLOT_A >= OFFSET_TELEMETRY_ENCODING + 2, "slots overlap the legacy layout");
+    static_assert(OFFSET_SLOT_B + SLOT_SIZE <= EEPROM_SIZE, "slot B is outside the EEPROM");
+
+    const ConfigRecord *validSlot(int addr);
+    bool recordSeen();
+    void eraseLegacy();
+    void loadFrom(const ConfigRecord &slot);
+    void setDefaults();
+    void migrateLegacy();
+    void readStringFromEEPROM(int addr, char *buffer, size_t maxLen);
+
+    static uint32_t crc32(const uint8_t *data, size_t len);
+};
@@ -0,0 +1,90 @@
+#include "EventStream.h"
+
+bool EventStream::subscribe(const WiFiClient &client)
+{
+    for (Subscriber &sub : subscribers)
+    {
+        if (sub.active)
+            continue;
+
+        // the copy keeps the connection open after the request handler returns
+        sub.client = client;
+        sub.client.setNoDelay(true);
+        sub.cursor = head;
+        sub.lastWrite = millis();
+        sub.active = true;
+        return true;
+    }
+    return false;
+}
+
+void EventStream::push(const char *name, const char *data)
+{
+    Event &event = ring[head % QUEUE_SIZE];
+    int len = snprintf_P(event.text, sizeof(event.text), PSTR("event: %s\ndata: %s\n\n"), name, data);
+    if (len < 0 || (size_t)len >= sizeof(event.text))
+    {
+        // a cut event would break the stream framing
+        _tooLong++;
+        return;
+    }
+
+    event.len = len;
+    head++;
+}
+
+uint8_t EventStream::clients() const
+{
+    uint8_t count = 0;
+    for (const Subscriber &sub : subscribers)
+    {
+        if (sub.active)
+            count++;
+    }
+    return count;
+}
+
+bool EventStream::write(Subscriber &sub, const char *text, size_t len)
+{
+    if (sub.client.availableForWrite() < (int)len)
+        return false;
+
+    sub.client.write(text, len);
+    sub.lastWrite = millis();
+    return true;
+}
+
+void EventStream::loop()
+{
+    for (Subscriber &sub : subscribers)
+    {
+        if (!sub.active)
+            continue;
+
+        if (!sub.client.connected())
+        {
+            sub.client.stop();
+            sub.active = false;
+            continue;
+        }
+
+        // drop-oldest: skip what the ring no longer holds
+        if (head - sub.cursor > QUEUE_SIZE)
+        {
+            _dropped += head - sub.cursor - QUEUE_SIZE;
+            sub.cursor = head - QUEUE_SIZE;
+        }
+
+        while (sub.cursor != head)
+        {
+            const Event &event = ring[sub.cursor % QUEUE_SIZE];
+            if (!write(sub, event.text, event.len))
+                break; // send buffer full, retried on the next loop
+            sub.cursor++;
+        }
+
+        // comment line, keeps proxies and the browser from timing out
+        if (millis() - sub.lastWrite >= KEEPALIVE_MS)
+            write(sub, ":\n\n", 3);
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef EVENT_STREAM_H
+#define EVENT_STREAM_H
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+
+// Server-Sent Events for the web panel (text/event-stream).
+// Events go into one shared ring; every subscriber has its own cursor
+// into it, so a slow client only loses its oldest events (counted in
+// dropped()) and never makes loop() wait: an event is written only when
+// the TCP send buffer can take all of it. An event longer than a slot is
+// not sent at all (counted in tooLong()).
+class EventStream
+{
+public:
+    static const uint8_t MAX_CLIENTS = 3;
+    static const uint8_t QUEUE_SIZE = 8; // events kept per client at most
+    static const size_t DATA_SIZE = 256; // longest data line pushed (config/raw JSON)
+    static const size_t EVENT_SIZE = DATA_SIZE + 32; // + "event: <name>\ndata: " and "\n\n"
+    static const unsigned long KEEPALIVE_MS = 15000;
+
+    // takes over a client whose response headers were already sent
+    bool subscribe(const WiFiClient &client);
+
+    // "event: <name>\ndata: <data>\n\n", data must be one line (JSON)
+    void push(const char *name, const char *data);
+
+    void loop();
+
+    uint8_t clients() const;
+    uint32_t dropped() const { return _dropped; }
+    uint32_t tooLong() const { return _tooLong; }
+
+private:
+    struct Event
+    {
+        char text[EVENT_SIZE];
+        uint16_t len;
+    };
+
+    struct Subscriber
+    {
+        WiFiClient client;
+        uint32_t cursor; // sequence number of the next event to send
+        unsigned long lastWrite;
+        bool active;
+    };
+
+    Event ring[QUEUE_SIZE] = {};
+    uint32_t head = 0; // sequence number of the next pushed event
+    Subscriber subscribers[MAX_CLIENTS];
+    uint32_t _dropped = 0;
+    uint32_t _tooLong = 0;
+
+    bool write(Subscriber &sub, const char *text, size_t len);
+};
+
+#endif // EVENT_STREAM_H
@@ -0,0 +1,67 @@
+#include "HeapMonitor.h"
+
+void HeapMonitor::setThresholds(uint32_t reconnect, uint32_t restart)
+{
+    reconnectBlock = reconnect;
+    restartBlock = restart;
+}
+
+const HeapSample &HeapMonitor::sample(const char *point)
+{
+    uint32_t freeHeap = 0;
+    uint32_t maxBlock = 0;
+    uint8_t fragmentation = 0;
+    ESP.getHeapStats(&freeHeap, &maxBlock, &fragmentation);
+
+    _last.freeHeap = freeHeap;
+    _last.maxBlock = maxBlock;
+    _last.fragmentation = fragmentation;
+    _last.freeStack = ESP.getFreeContStack();
+
+    if (_last.freeHeap < _worst.freeHeap)
+        _worst.freeHeap = _last.freeHeap;
+    if (_last.maxBlock < _worst.maxBlock)
+    {
+        _worst.maxBlock = _last.maxBlock;
+        _worstPoint = point;
+    }
+    if (_last.fragmentation > _worst.fragmentation)
+        _worst.fragmentation = _last.fragmentation;
+    if (_last.freeStack < _worst.freeStack)
+        _worst.freeStack = _last.freeStack;
+
+    return _last;
+}
+
+HeapAction HeapMonitor::check(bool connected)
+{
+    if (!reconnectBlock)
+        return HEAP_OK;
+
+    if (!connected)
+    {
+        // after our reconnect: the next handshake needs its buffer in one block
+        if (episodeReconnects && (_last.maxBlock < restartBlock || _last.maxBlock < handshakeBlock))
+            return HEAP_RESTART;
+        return HEAP_OK;
+    }
+
+    if (_last.maxBlock >= reconnectBlock)
+    {
+        if (episodeReconnects && ++healthyChecks >= RECOVERY_CHECKS)
+        {
+            episodeReconnects = 0;
+            healthyChecks = 0;
+        }
+        return HEAP_OK;
+    }
+
+    healthyChecks = 0;
+    // the reconnect freed what it could, or reconnecting does not help
+    if (episodeReconnects && (_last.maxBlock < restartBlock || episodeReconnects >= MAX_RECONNECTS))
+        return HEAP_RESTART;
+
+    episodeReconnects++;
+    _reconnects++;
+    return HEAP_RECONNECT;
+}
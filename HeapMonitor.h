@@ -0,0 +1,62 @@
+#ifndef HEAP_MONITOR_H
+#define HEAP_MONITOR_H
+
+#include <Arduino.h>
+
+struct HeapSample
+{
+    uint32_t freeHeap;     // bytes
+    uint32_t maxBlock;     // largest allocatable block, bytes
+    uint8_t fragmentation; // %
+    uint32_t freeStack;    // cont stack never touched since boot, bytes
+};
+
+enum HeapAction : uint8_t
+{
+    HEAP_OK = 0,
+    HEAP_RECONNECT, // drop TLS so BearSSL buffers are allocated again
+    HEAP_RESTART,   // a reconnect did not help
+};
+
+// Heap / stack observability: samples at key points (TLS connect,
+// HTTP request, publish), keeps the worst values since boot and decides
+// when fragmentation is about to break the next TLS handshake.
+class HeapMonitor
+{
+public:
+    static const uint8_t RECOVERY_CHECKS = 6; // healthy checks while connected that end an episode
+    static const uint8_t MAX_RECONNECTS = 3;  // reconnects in one episode before a restart
+
+    // reconnect below reconnectBlock, restart if still below restartBlock after it
+    void setThresholds(uint32_t reconnectBlock, uint32_t restartBlock);
+    // largest single allocation of a TLS handshake (the RX buffer); while a
+    // reconnect is pending a smaller block means it cannot succeed
+    void setHandshakeBlock(uint32_t bytes) { handshakeBlock = bytes; }
+
+    const HeapSample &sample(const char *point);
+
+    // call from a periodic task, uses the latest sample; `connected`: TLS is
+    // up, i.e. its buffers are allocated and the block is what is left
+    HeapAction check(bool connected);
+
+    const HeapSample &last() const { return _last; }
+    const HeapSample &worst() const { return _worst; }
+    // sample point where the largest block was smallest
+    const char *worstPoint() const { return _worstPoint; }
+    uint16_t reconnects() const { return _reconnects; }
+
+private:
+    HeapSample _last = {};
+    HeapSample _worst = {UINT32_MAX, UINT32_MAX, 0, UINT32_MAX};
+    const char *_worstPoint = "";
+    uint32_t reconnectBlock = 0;
+    uint32_t restartBlock = 0;
+    uint32_t handshakeBlock = 0;
+    uint16_t _reconnects = 0;
+    // episode: from the first low block until it stayed healthy RECOVERY_CHECKS
+    // times while connected (right after a disconnect it always looks healthy)
+    uint8_t episodeReconnects = 0;
+    uint8_t healthyChecks = 0;
+};
+
+#endif // HEAP_MONITOR_H
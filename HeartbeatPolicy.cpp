@@ -0,0 +1,55 @@
+#include "HeartbeatPolicy.h"
+
+void HeartbeatPolicy::configure(unsigned long keepaliveMs, unsigned long minIntervalMs, uint8_t rssiBucketDb)
+{
+    keepalive = keepaliveMs;
+    minInterval = minIntervalMs;
+    bucketDb = rssiBucketDb ? rssiBucketDb : 1;
+}
+
+HeartbeatReason HeartbeatPolicy::connected(uint32_t ip, int rssi, unsigned long now)
+{
+    return publish(HEARTBEAT_CONNECT, ip, rssi, now);
+}
+
+HeartbeatReason HeartbeatPolicy::offer(uint32_t ip, int rssi, bool mqttConnected, unsigned long now)
+{
+    if (!mqttConnected || now - lastPublish < minInterval)
+        return HEARTBEAT_NONE;
+
+    // hysteresis: measured from the published value, not from bucket edges
+    if (ip != lastIp)
+        return publish(HEARTBEAT_IP, ip, rssi, now);
+    if (abs(rssi - lastRssi) >= bucketDb)
+        return publish(HEARTBEAT_RSSI, ip, rssi, now);
+    if (now - lastPublish >= keepalive)
+        return publish(HEARTBEAT_KEEPALIVE, ip, rssi, now);
+    return HEARTBEAT_NONE;
+}
+
+HeartbeatReason HeartbeatPolicy::publish(HeartbeatReason reason, uint32_t ip, int rssi, unsigned long now)
+{
+    lastIp = ip;
+    lastRssi = rssi;
+    lastPublish = now;
+    _published++;
+    return reason;
+}
+
+const char *HeartbeatPolicy::reasonName(HeartbeatReason reason)
+{
+    switch (reason)
+    {
+    case HEARTBEAT_NONE:
+        return "none";
+    case HEARTBEAT_CONNECT:
+        return "connect";
+    case HEARTBEAT_IP:
+        return "ip";
+    case HEARTBEAT_RSSI:
+        return "rssi";
+    case HEARTBEAT_KEEPALIVE:
+        return "keepalive";
+    }
+    return "unknown";
+}
@@ -0,0 +1,50 @@
+#ifndef HEARTBEAT_POLICY_H
+#define HEARTBEAT_POLICY_H
+
+#include <Arduino.h>
+
+enum HeartbeatReason : uint8_t
+{
+    HEARTBEAT_NONE = 0,
+    HEARTBEAT_CONNECT,   // MQTT (re)connected
+    HEARTBEAT_IP,        // new IP address
+    HEARTBEAT_RSSI,      // RSSI moved by a bucket since the last heartbeat
+    HEARTBEAT_KEEPALIVE, // nothing changed for keepaliveMs
+};
+
+// Decides when device/status goes out: right after a (re)connect, when
+// the IP changes or the RSSI moves by rssiBucketDb or more from the last
+// published value (at most once per minIntervalMs; a signal hovering
+// around a bucket edge does not flood), and otherwise every keepaliveMs.
+// "offline" is the broker's Last Will, not a heartbeat.
+class HeartbeatPolicy
+{
+public:
+    void configure(unsigned long keepaliveMs, unsigned long minIntervalMs, uint8_t rssiBucketDb);
+
+    // on a successful MQTT connect, which publishes at once: the state is
+    // taken as published, returns HEARTBEAT_CONNECT
+    HeartbeatReason connected(uint32_t ip, int rssi, unsigned long now);
+
+    // called periodically; a reason other than HEARTBEAT_NONE means
+    // "publish now", the state is then taken as published
+    HeartbeatReason offer(uint32_t ip, int rssi, bool mqttConnected, unsigned long now);
+
+    uint32_t published() const { return _published; }
+
+    static const char *reasonName(HeartbeatReason reason);
+
+private:
+    unsigned long keepalive = 300000;
+    unsigned long minInterval = 5000;
+    uint8_t bucketDb = 10;
+
+    uint32_t lastIp = 0;
+    int lastRssi = 0;
+    unsigned long lastPublish = 0;
+    uint32_t _published = 0;
+
+    HeartbeatReason publish(HeartbeatReason reason, uint32_t ip, int rssi, unsigned long now);
+};
+
+#endif // HEARTBEAT_POLICY_H
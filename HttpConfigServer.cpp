@@ -1,4 +1,6 @@
 #include "HttpConfigServer.h"
+#include <lwip/opt.h> // TCP_MSS
+#include "JsonString.h"
 
 HttpConfigServer::HttpConfigServer(int port,
                                    std::function<void(const char *, const char *, const char *, const char *,
@@ -16,10 +18,21 @@ void HttpConfigServer::begin()
     Serial.println("Starting HTTP server...");
   }
 
-  server.on("/", HTTP_GET, [this]()
-            { handleRoot(); });
+  for (const WebAsset &asset : WEB_ASSETS)
+  {
+    server.on(asset.path, HTTP_GET, [this, &asset]()
+              { handleAsset(asset); });
+  }
   server.on("/send", HTTP_GET, [this]()
             { handleSendCommand(); });
+  server.on("/result", HTTP_GET, [this]()
+            { handleCommandResult(); });
+  server.on("/history", HTTP_GET, [this]()
+            { handleHistory(); });
+  server.on("/metrics", HTTP_GET, [this]()
+            { handleMetrics(); });
+  server.on("/events", HTTP_GET, [this]()
+            { handleEvents(); });
   server.on("/config", HTTP_GET, [this]()
             { handleConfigPage(); });
   server.on("/config", HTTP_POST, [this]()
@@ -28,6 +41,14 @@ void HttpConfigServer::begin()
             { handleStatus(); });
   server.onNotFound([this]()
                     { handleNotFound(); });
+  server.addHook([this](const String &, const String &, WiFiClient *, ESP8266WebServer::ContentTypeFunction)
+                 {
+                   if (requestCallback)
+                     requestCallback();
+                   return ESP8266WebServer::CLIENT_REQUEST_CAN_CONTINUE; });
+  // cached pages are revalidated with their ETag
+  const char *headerKeys[] = {"If-None-Match"};
+  server.collectHeaders(headerKeys, 1);
   server.begin();
   if (isSerialDebug)
   {
@@ -38,6 +59,7 @@ void HttpConfigServer::begin()
 void HttpConfigServer::loop()
 {
   server.handleClient();
+  events.loop();
 }
 
 void HttpConfigServer::handleSendCommand()
@@ -46,7 +68,7 @@ void HttpConfigServer::handleSendCommand()
   {
     return server.requestAuthentication();
   }
-  char command[32] = {0};
+  char command[48] = {0};
   strncpy(command, server.arg("command").c_str(), sizeof(command) - 1);
 
   // Check for 'reset_wifi' command
@@ -62,111 +84,293 @@ void HttpConfigServer::handleSendCommand()
     return;
   }
 
-  if (isSerialDebug)
+  if (isSerialDebug || unitCount == 0)
   {
     server.send(423, "application/json", FPSTR(ERROR_UART_IS_SHUTDOWN));
     return;
   }
 
-  char response[32] = {0};
-  size_t response_index = 0;
+  XYCommandQueue *queue = requestedQueue();
+  if (!queue)
+  {
+    server.send(404, "application/json", FPSTR(ERROR_UNKNOWN_UNIT));
+    return;
+  }
 
-  loraSerial->print(command);
+  // Queue the command and return at once, the reply is picked up from /result
+  uint16_t id = queue->enqueue(command, XY_CMD_HTTP);
+  if (id == 0)
+  {
+    server.send(503, "application/json", FPSTR(ERROR_QUEUE_FULL));
+    return;
+  }
 
-  // Receive response with 500ms timeout
-  unsigned long start = millis();
-  while (millis() - start < 500 && response_index < sizeof(response) - 1)
+  // command, client id and unit are char arrays / String, so they are copied
+  StaticJsonDocument<JSON_OBJECT_SIZE(5) + sizeof(command) + sizeof(_client_id) + 16> doc;
+  doc["id"] = id;
+  doc["cmd"] = command;
+  doc["status"] = "queued";
+  doc["device_id"] = _client_id;
+  if (unitCount > 1)
   {
-    if (loraSerial->available())
-    {
-      char c = loraSerial->read();
-      response[response_index++] = c;
-    }
+    doc["unit"] = server.arg("unit");
   }
 
-  response[response_index] = '\0'; // Force null-termination
+  char jsonOut[192] = {0};
+  serializeJson(doc, jsonOut, sizeof(jsonOut));
+  server.sendHeader("Access-Control-Allow-Origin", "*");
+  server.send(202, "application/json", jsonOut);
+}
 
-  StaticJsonDocument<128> doc;
-  doc["cmd"] = command;
-  doc["response"] = response;
+void HttpConfigServer::handleCommandResult()
+{
+  if (!isAuthorized())
+  {
+    return server.requestAuthentication();
+  }
+
+  uint16_t id = server.arg("id").toInt();
+  // ids are per queue, so the unit of /send is needed here too
+  XYCommandQueue *queue = requestedQueue();
+  const XYCommand *cmd = queue ? queue->find(id) : nullptr;
+  if (!cmd)
+  {
+    server.send(404, "application/json", FPSTR(ERROR_UNKNOWN_COMMAND_ID));
+    return;
+  }
+
+  bool finished = cmd->state == XY_CMD_DONE || cmd->state == XY_CMD_TIMEOUT;
+
+  StaticJsonDocument<JSON_OBJECT_SIZE(6) + sizeof(cmd->command) + sizeof(cmd->response) + sizeof(_client_id) + 16> doc;
+  doc["id"] = cmd->id;
+  doc["cmd"] = cmd->command;
+  doc["status"] = !finished                       ? "pending"
+                  : cmd->state == XY_CMD_TIMEOUT ? "timeout"
+                                                  : "done";
+  doc["response"] = cmd->response;
   doc["device_id"] = _client_id;
+  if (unitCount > 1)
+  {
+    doc["unit"] = server.arg("unit");
+  }
 
-  char jsonOut[128] = {0};
+  char jsonOut[320] = {0};
   serializeJson(doc, jsonOut, sizeof(jsonOut));
+
+  // result is delivered once
+  if (finished)
+  {
+    queue->release(id);
+  }
+
   server.sendHeader("Access-Control-Allow-Origin", "*");
   server.send(200, "application/json", jsonOut);
 }
 
-void HttpConfigServer::handleRoot()
+namespace
 {
+  // Handlers run one at a time, so the ChunkPrinters share one segment
+  // buffer instead of putting TCP_MSS bytes on the 4 KB cont stack
+  char chunkBuf[TCP_MSS];
+
+  // Print that coalesces output into one TCP segment per write
+  // (works for chunked and fixed-length responses)
+  class ChunkPrinter : public Print
+  {
+  public:
+    explicit ChunkPrinter(ESP8266WebServer &server) : server(server) {}
+    ~ChunkPrinter() { flush(); }
 
+    size_t write(uint8_t c) override
+    {
+      if (len == sizeof(chunkBuf))
+        flush();
+      chunkBuf[len++] = c;
+      return 1;
+    }
+
+    void flush() override
+    {
+      if (len)
+        server.sendContent(chunkBuf, len);
+      len = 0;
+    }
+
+  private:
+    ESP8266WebServer &server;
+    size_t len = 0;
+  };
+}
+
+void HttpConfigServer::handleHistory()
+{
   if (!isAuthorized())
   {
     return server.requestAuthentication();
   }
 
-  // 1. Headers preparation (without auto closing the connection)
+  HistoryTier tier = HISTORY_RAW;
+  if (!history || (server.hasArg("tier") && !TelemetryHistory::parseTier(server.arg("tier").c_str(), tier)))
+  {
+    server.send(400, "application/json", FPSTR(ERROR_UNKNOWN_TIER));
+    return;
+  }
+
+  // Rows are streamed in segments, the whole response never sits in RAM
   server.setContentLength(CONTENT_LENGTH_UNKNOWN);
-  server.sendHeader("Content-Type", "text/html; charset=UTF-8");
-  server.send(200, "text/html", "");
-  // 2. Send HTML in chunks
-  sendChunk(HTML_HEADER);
-  sendChunk(ROOT_HTML);
+  server.send(200, "application/json", "");
+
+  ChunkPrinter out(server);
+  out.printf_P(PSTR("{\"tier\":\"%s\",\"device_id\":"),
+               server.arg("tier").length() ? server.arg("tier").c_str() : "raw");
+  writeJsonString(out, _client_id);
+  out.print(F(",\"samples\":["));
+
+  uint16_t count = history->count(tier);
+  for (uint16_t i = 0; i < count; ++i)
+  {
+    const char *sep = i ? "," : "";
+    if (tier == HISTORY_RAW)
+    {
+      HistorySample s;
+      history->sampleAt(i, s);
+      out.printf_P(PSTR("%s[%u,%u,%u,%u]"), sep, s.time, s.centivolts, s.percent, s.state);
+    }
+    else
+    {
+      HistoryBucket b;
+      history->bucketAt(tier, i, b);
+      out.printf_P(PSTR("%s[%u,%u,%u,%u,%u,%u,%u]"),
+                   sep, b.start, b.minCentivolts, b.maxCentivolts,
+                   b.sumCentivolts / b.count, b.minPercent, b.maxPercent,
+                   b.sumPercent / b.count);
+    }
+  }
+
+  out.print(F("]}"));
 }
 
-void HttpConfigServer::handleConfigPage()
+// Server-Sent Events: the connection is handed over to the EventStream,
+// as in the ESP8266WebServer ServerSentEvents example
+void HttpConfigServer::handleEvents()
+{
+  if (!isAuthorized())
+  {
+    return server.requestAuthentication();
+  }
+
+  if (events.clients() >= EventStream::MAX_CLIENTS)
+  {
+    server.send(503, "application/json", FPSTR(ERROR_TOO_MANY_STREAMS));
+    return;
+  }
+
+  WiFiClient client = server.client();
+  client.print(F("HTTP/1.1 200 OK\r\n"
+                 "Content-Type: text/event-stream\r\n"
+                 "Cache-Control: no-cache\r\n"
+                 "Connection: keep-alive\r\n\r\n"
+                 "retry: 3000\n\n"));
+  events.subscribe(client);
+
+  // current state first, the panel has no other source for it
+  char jsonBuffer[sizeof(MQTT_CONN_STATUS_JSON) + 32];
+  formatMqttStatus(jsonBuffer, sizeof(jsonBuffer));
+  events.push("mqtt", jsonBuffer);
+}
+
+void HttpConfigServer::pushEvent(const char *name, const char *data)
+{
+  events.push(name, data);
+}
+
+void HttpConfigServer::handleMetrics()
 {
   if (!isAuthorized())
   {
     return server.requestAuthentication();
   }
 
-  char port_str[6];
-  snprintf(port_str, sizeof(port_str), "%u", _mqtt_port);
+  if (!metrics)
+  {
+    server.send(404, "text/plain", "");
+    return;
+  }
 
-  // 1. Headers preparation (without auto closing the connection)
   server.setContentLength(CONTENT_LENGTH_UNKNOWN);
-  server.sendHeader("Content-Type", "text/html; charset=UTF-8");
-  server.send(200, "text/html", "");
-  // 2. Send HTML in chunks
-  sendChunk(HTML_HEADER);
-  sendChunk(HTML_SETTINGS_START);
-
-  // insert intput for _mqtt_ip
-  sendChunk(HTML_SETTINGS_INPUT_MQTT_SERVER);
-  sendChunk(_mqtt_ip);
-  sendChunk(HTML_SETTINGS_INPUT_END);
-  // End insert intput for _mqtt_ip
-
-  // insert intput for _mqtt_port
-  sendChunk(HTML_SETTINGS_MQTT_PORT_LABEL);
-  sendChunk(HTML_SETTINGS_INPUT_MQTT_PORT);
-  sendChunk(port_str);
-  sendChunk(HTML_SETTINGS_INPUT_END);
-  // End insert intput for _mqtt_port
-
-  // insert intput for _mqtt_user
-  sendChunk(HTML_SETTINGS_MQTT_USER_LABEL);
-  sendChunk(HTML_SETTINGS_MQTT_USER);
-  sendChunk(_mqtt_user);
-  sendChunk(HTML_SETTINGS_INPUT_END);
-  // End insert intput for _mqtt_user
-
-  // insert intput for _mqtt_pass
-  sendChunk(HTML_SETTINGS_MQTT_PASS_LABEL);
-  sendChunk(HTML_SETTINGS_MQTT_PASS);
-  sendChunk(_mqtt_pass);
-  sendChunk(HTML_SETTINGS_INPUT_END);
-  // End insert intput for _mqtt_pass
-
-  // insert intput for _client_id
-  sendChunk(HTML_SETTINGS_MQTT_CLIENT_ID_LABEL);
-  sendChunk(HTML_SETTINGS_MQTT_CLIENT_ID);
-  sendChunk(_client_id);
-  sendChunk(HTML_SETTINGS_INPUT_END);
-  // End insert intput for _client_id
-
-  sendChunk(HTML_SETTINGS_HTML_END);
+  server.send(200, "text/plain; version=0.0.4", "");
+
+  ChunkPrinter out(server);
+  metrics->writePrometheus(out);
+  out.printf_P(PSTR("# HELP xy_events_dropped_total Server-sent events not delivered to a panel\n"
+                    "# TYPE xy_events_dropped_total counter\n"
+                    "xy_events_dropped_total{reason=\"slow_client\"} %lu\n"
+                    "xy_events_dropped_total{reason=\"too_long\"} %lu\n"),
+               (unsigned long)events.dropped(), (unsigned long)events.tooLong());
+}
+
+// Pre-compressed static page: sent as is with its length, revalidated by ETag
+void HttpConfigServer::handleAsset(const WebAsset &asset)
+{
+  if (!isAuthorized())
+  {
+    return server.requestAuthentication();
+  }
+
+  server.sendHeader("ETag", asset.etag);
+  server.sendHeader("Cache-Control", asset.immutable ? "private, max-age=31536000, immutable" : "private, no-cache");
+
+  if (server.header("If-None-Match") == asset.etag)
+  {
+    server.send(304);
+    return;
+  }
+
+  server.sendHeader("Content-Encoding", "gzip");
+  server.send_P(200, asset.contentType, (PGM_P)asset.gzData, asset.gzLength);
+}
+
+void HttpConfigServer::handleConfigPage()
+{
+  if (!isAuthorized())
+  {
+    return server.requestAuthentication();
+  }
+
+  char port[6];
+  char dv[6], dp[4], silence[6], window[6], batch[4], flush[6];
+  snprintf_P(port, sizeof(port), PSTR("%u"), _mqtt_port);
+  snprintf_P(dv, sizeof(dv), PSTR("%u"), _publishPolicy.voltageDeadband);
+  snprintf_P(dp, sizeof(dp), PSTR("%u"), _publishPolicy.percentDeadband);
+  snprintf_P(silence, sizeof(silence), PSTR("%u"), _publishPolicy.maxSilenceSec);
+  snprintf_P(window, sizeof(window), PSTR("%u"), _publishPolicy.coalesceMs);
+  snprintf_P(batch, sizeof(batch), PSTR("%u"), _publishPolicy.batchSize);
+  snprintf_P(flush, sizeof(flush), PSTR("%u"), _publishPolicy.batchFlushSec);
+
+  const TemplateVar vars[] = {
+      {"mqtt_ip", _mqtt_ip},
+      {"mqtt_port", port},
+      {"mqtt_user", _mqtt_user},
+      {"mqtt_pass", _mqtt_pass},
+      {"client_id", _client_id},
+      {"pub_dv", dv},
+      {"pub_dp", dp},
+      {"pub_silence", silence},
+      {"pub_window", window},
+      {"pub_batch", batch},
+      {"pub_flush", flush},
+  };
+  static_assert(sizeof(vars) / sizeof(vars[0]) == SETTINGS_FIELD_COUNT, "a settings field has no value");
+
+  const char *const parts[] = {HTML_HEADER, HTML_SETTINGS_PAGE};
+  PageTemplate page(parts, 2, vars, SETTINGS_FIELD_COUNT);
+
+  // exact length: no chunked framing, the body goes out in full segments
+  server.setContentLength(page.length());
+  server.send(200, "text/html; charset=UTF-8", "");
+
+  ChunkPrinter out(server);
+  page.render(out);
 }
 
 void HttpConfigServer::handleSaveConfig()
@@ -220,6 +424,24 @@ void HttpConfigServer::handleSaveConfig()
     Serial.printf_P(PSTR("client_id: %s\n"), client_id);
   }
 
+  // staged first, written together with the rest of the form by saveCallback
+  if (server.hasArg("pub_dv"))
+  {
+    PublishPolicyConfig policy = _publishPolicy;
+    policy.voltageDeadband = constrain(server.arg("pub_dv").toInt(), 0L, 0xFFFFL);
+    policy.percentDeadband = constrain(server.arg("pub_dp").toInt(), 0L, 100L);
+    policy.maxSilenceSec = constrain(server.arg("pub_silence").toInt(), 0L, 0xFFFFL);
+    policy.coalesceMs = constrain(server.arg("pub_window").toInt(), 0L, 0xFFFFL);
+    policy.batchSize = constrain(server.arg("pub_batch").toInt(), 1L, 16L);
+    policy.batchFlushSec = constrain(server.arg("pub_flush").toInt(), 0L, 0xFFFFL);
+    _publishPolicy = policy;
+
+    if (publishPolicyCallback)
+    {
+      publishPolicyCallback(policy);
+    }
+  }
+
   // Save to EEPROM
   saveCallback(mqtt_ip, mqtt_port, mqtt_user, mqtt_pass, client_id, newAuthUser, newAuthPass);
 
@@ -234,23 +456,77 @@ void HttpConfigServer::handleNotFound()
 
 void HttpConfigServer::handleStatus()
 {
-  char jsonBuffer[sizeof(MQTT_CONN_STATUS_JSON) + 16];
-
-  snprintf_P(jsonBuffer, sizeof(jsonBuffer),
-             MQTT_CONN_STATUS_JSON,
-             mqttConnected ? STATUS_CONNECTED : STATUS_DISCONNECTED);
+  char jsonBuffer[sizeof(MQTT_CONN_STATUS_JSON) + 32];
+  formatMqttStatus(jsonBuffer, sizeof(jsonBuffer));
 
   server.send(200, FPSTR("application/json"), jsonBuffer);
 }
 
+void HttpConfigServer::formatMqttStatus(char *out, size_t size) const
+{
+  snprintf_P(out, size, MQTT_CONN_STATUS_JSON,
+             mqttConnected ? STATUS_CONNECTED : STATUS_DISCONNECTED,
+             mqttRetry, (unsigned long)mqttNextMs);
+}
+
 void HttpConfigServer::setMqttConnected(bool state)
 {
+  if (state == mqttConnected)
+    return;
   mqttConnected = state;
+  if (state)
+  {
+    mqttRetry = 0;
+    mqttNextMs = 0;
+  }
+
+  char jsonBuffer[sizeof(MQTT_CONN_STATUS_JSON) + 32];
+  formatMqttStatus(jsonBuffer, sizeof(jsonBuffer));
+  events.push("mqtt", jsonBuffer);
+}
+
+void HttpConfigServer::setMqttRetry(uint16_t attempt, uint32_t nextMs)
+{
+  mqttRetry = attempt;
+  mqttNextMs = nextMs;
+
+  char jsonBuffer[sizeof(MQTT_CONN_STATUS_JSON) + 32];
+  formatMqttStatus(jsonBuffer, sizeof(jsonBuffer));
+  events.push("mqtt", jsonBuffer);
+}
+
+void HttpConfigServer::addCommandQueue(XYCommandQueue *queue, const char *unit)
+{
+  if (unitCount >= MAX_UNITS)
+  {
+    return;
+  }
+  commandQueues[unitCount] = queue;
+  unitNames[unitCount] = unit ? unit : "";
+  unitCount++;
 }
 
-void HttpConfigServer::setLoraSerial(SoftwareSerial *serial)
+XYCommandQueue *HttpConfigServer::requestedQueue()
 {
-  loraSerial = serial;
+  if (unitCount == 0)
+  {
+    return nullptr;
+  }
+
+  const String &unit = server.arg("unit");
+  if (unit.length() == 0)
+  {
+    return commandQueues[0];
+  }
+
+  for (uint8_t i = 0; i < unitCount; i++)
+  {
+    if (unit == unitNames[i])
+    {
+      return commandQueues[i];
+    }
+  }
+  return nullptr;
 }
 
 bool HttpConfigServer::isAuthorized()
@@ -285,17 +561,27 @@ void HttpConfigServer::setMQTT(const char *mqtt_ip, uint16_t mqtt_port,
   _mqtt_port = mqtt_port;
 }
 
-void HttpConfigServer::sendChunk(const char *data)
+void HttpConfigServer::setHistory(const TelemetryHistory *hist)
 {
-  char buf[128];
-  size_t len = strlen_P(data);
-  size_t sent = 0;
+  history = hist;
+}
 
-  while (sent < len)
-  {
-    size_t chunk = min(sizeof(buf), len - sent);
-    memcpy_P(buf, data + sent, chunk);
-    server.sendContent(buf, chunk);
-    sent += chunk;
-  }
-}
\ No newline at end of file
+void HttpConfigServer::onRequest(std::function<void()> cb)
+{
+  requestCallback = cb;
+}
+
+void HttpConfigServer::setMetrics(const LoopMetrics *loopMetrics)
+{
+  metrics = loopMetrics;
+}
+
+void HttpConfigServer::setPublishPolicy(const PublishPolicyConfig &cfg)
+{
+  _publishPolicy = cfg;
+}
+
+void HttpConfigServer::onPublishPolicySave(std::function<void(const PublishPolicyConfig &)> cb)
+{
+  publishPolicyCallback = cb;
+}
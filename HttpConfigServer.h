@@ -5,10 +5,21 @@
 #include <ESP8266WebServer.h>
 #include <Arduino.h>
 #include <ArduinoJson.h>
-#include <SoftwareSerial.h>
+#include "XYCommandQueue.h"
+#include "PublishPolicy.h"
+#include "TelemetryHistory.h"
+#include "LoopMetrics.h"
+#include "WebAssets.h"
+#include "PageTemplate.h"
+#include "EventStream.h"
 
 const char ERROR_EMPTY_COMMAND[] PROGMEM = "{\"error\":\"Empty command\"}";
 const char ERROR_UART_IS_SHUTDOWN[] PROGMEM = "{\"error\":\"UART is shut down (debug mode)\"}";
+const char ERROR_QUEUE_FULL[] PROGMEM = "{\"error\":\"Command queue is full\"}";
+const char ERROR_UNKNOWN_COMMAND_ID[] PROGMEM = "{\"error\":\"Unknown command id\"}";
+const char ERROR_UNKNOWN_TIER[] PROGMEM = "{\"error\":\"Unknown tier (raw, 1m, 15m)\"}";
+const char ERROR_TOO_MANY_STREAMS[] PROGMEM = "{\"error\":\"Too many event streams\"}";
+const char ERROR_UNKNOWN_UNIT[] PROGMEM = "{\"error\":\"Unknown unit\"}";
 
 const char HTML_HEADER[] PROGMEM = R"=====(<!DOCTYPE html><!DOCTYPE html>
   <html>
@@ -34,144 +45,11 @@ const char HTML_HEADER[] PROGMEM = R"=====(<!DOCTYPE html><!DOCTYPE html>
   <body>
 )=====";
 
-const char ROOT_HTML[] PROGMEM = R"=====(
-  <body>
-    <header>
-    <a href="/config">Settings</a>
-    <div id="mqttStatus" style="font-weight:bold; margin-top:10px;"></div>
-
-    </header>
-    <hr>
-    <h2>XY-Lx0A — Control</h1>
-    <hr>
-    <button class="btn" onclick="sendCommand('on', event)">on</button>
-    <button class="btn" onclick="sendCommand('off', event)">off</button>
-    <button class="btn" onclick="sendCommand('read', event)">read</button>
-    <button class="btn" onclick="sendCommand('start', event)">start</button>
-    <button class="btn" onclick="sendCommand('stop', event)">stop</button>
-    
-    <div>
-      <input type="number" step="0.1" id="dw">
-      <button class="btn" onclick="setDW(event)">dw</button>
-    </div>
-
-    <div>
-      <input type="number" step="0.1" id="up">
-      <button class="btn" onclick="setUP(event)">up</button>
-    </div>
-
-    <div>
-      <input type="time" id="timer">
-      <button class="btn" onclick="setTimer(event)">timer</button>
-    </div>
-    <hr>
-    <form name="publish">
-      <input type="text" name="message">
-      <input type="submit" value="Send">
-    </form>
-    <hr>
-    <button class="btn danger" onclick="confirmResetWifi(event)">Reset WIFI auth</button>
-    <hr>
-    <div id="messages" style="min-height:30px; border:solid 1px black; margin-top:10px; padding:5px;"></div>
-
-    <script>
-
-    function updateMQTTStatus() {
-      const el = document.getElementById("mqttStatus");      
-      fetch('/status', { credentials: 'include' })
-        .then(r => r.json())
-        .then(data => {          
-          if (data.mqtt === "connected") {
-            el.innerHTML = 'MQTT: <span style="color:green">Online</span>';
-          } else {
-            el.innerHTML = 'MQTT: <span style="color:red">Offline</span>';
-          }
-        });
-    }
-
-      setInterval(updateMQTTStatus, 5000);
-
-      function sendCommand(cmd, ev) {
-      if (ev) {
-        ev.preventDefault();
-        ev.stopPropagation();
-      }
-
-    return fetch('/send?command=' + encodeURIComponent(cmd))
-      .then(res => res.json())
-      .then(data => {
-        if(data.error) {
-          throw new Error(data.error);
-        }
-        const msg = document.createElement('div');
-        msg.innerHTML = `<b>${data.cmd}</b> → <pre>${data.response}</pre>`;
-        document.getElementById('messages').prepend(msg);
-        
-        if (data.cmd === "read" && typeof data.response === "string") {
-          const clean = data.response
-            .replace("dw", "")
-            .replace("up", "")
-            .replace("\n", "")
-            .trim();
-
-          const [dw, up, timer] = clean.split(",");
-
-          if (dw) document.getElementById('dw').value = dw;
-          if (up) document.getElementById('up').value = up;
-          if (timer) document.getElementById('timer').value = timer;
-        }
-
-        
-        if (typeof data.response === "string" && data.response.includes("DOWN")) {
-          sendCommand("read"); 
-        }
-
-        return data;
-      })
-      .catch(err => {
-        const error = document.createElement('div');
-        error.classList.add("danger-text");
-        error.textContent = "" + err;
-        document.getElementById('messages').prepend(error);
-        throw err;
-      });
-  }
-
-    function confirmResetWifi(event) {
-      if (window.confirm("Are you sure you want to reset wifi credentials?")) {
-        sendCommand('reset_wifi', event)
-      }
-    }
+// The control page (/ and /app.js) is served gzipped from WebAssets.h,
+// sources are in web/ (tools/build_web_assets.py)
 
-    window.addEventListener('DOMContentLoaded', () => {
-      sendCommand("read");
-      updateMQTTStatus();
-    });
-
-      function setDW(ev) {
-        const val = document.getElementById('dw').value;
-        sendCommand("dw" + val, ev);
-      }
-
-      function setUP(ev) {
-        const val = document.getElementById('up').value;
-        sendCommand("up" + val, ev);
-      }
-
-      function setTimer(ev) {
-        const val = document.getElementById('timer').value;
-        sendCommand(val, ev);
-      }
-
-      document.forms.publish.onsubmit = function(ev) {
-        const text = this.message.value;
-        sendCommand(text, ev);
-      };
-    </script>
-  </body>
-  </html>)=====";
-
-const char HTML_SETTINGS_START[] PROGMEM = R"=====(
+// Settings page, rendered by PageTemplate; every {{name}} is one SETTINGS_FIELDS entry
+constexpr char HTML_SETTINGS_PAGE[] PROGMEM = R"=====(
     <header><a href="/">XY-Lx0A Control</a></header>
     <hr>
     <h2>⚙️ Settings</h2><hr>
@@ -179,22 +57,30 @@ const char HTML_SETTINGS_START[] PROGMEM = R"=====(
     <fieldset>
       <legend>MQTT settings</legend>
         <label for="mqtt_ip">MQTT Server/Server IP:</label>
-)=====";
-
-const char HTML_SETTINGS_MQTT_PORT_LABEL[] PROGMEM = R"=====(<label for="mqtt_port">MQTT Port:</label>)=====";
-const char HTML_SETTINGS_MQTT_USER_LABEL[] PROGMEM = R"=====(<label for="mqtt_user">MQTT User:</label>)=====";
-const char HTML_SETTINGS_MQTT_PASS_LABEL[] PROGMEM = R"=====(<label for="mqtt_pass">MQTT Password:</label>)=====";
-const char HTML_SETTINGS_MQTT_CLIENT_ID_LABEL[] PROGMEM = R"=====(<label for="client_id">MQTT Client ID:</label>)=====";
-
-const char HTML_SETTINGS_INPUT_END[] PROGMEM = R"=====(">)=====";
-
-const char HTML_SETTINGS_INPUT_MQTT_SERVER[] PROGMEM = R"=====(<input class="w-100" id="mqtt_ip" type="text" name="mqtt_ip" value=")=====";
-const char HTML_SETTINGS_INPUT_MQTT_PORT[] PROGMEM = R"=====(<input class="w-100"  id="mqtt_port"  type="number" name="mqtt_port" min="1" max="65535" value=")=====";
-const char HTML_SETTINGS_MQTT_USER[] PROGMEM = R"=====(<input class="w-100" id="mqtt_user" type="text" name="mqtt_user" value=")=====";
-const char HTML_SETTINGS_MQTT_PASS[] PROGMEM = R"=====(<input class="w-100" id="mqtt_pass" type="text" name="mqtt_pass" value=")=====";
-const char HTML_SETTINGS_MQTT_CLIENT_ID[] PROGMEM = R"=====(<input class="w-100" id="client_id" type="text" name="client_id" value=")=====";
-
-const char HTML_SETTINGS_HTML_END[] PROGMEM = R"=====(
+        <input class="w-100" id="mqtt_ip" type="text" name="mqtt_ip" value="{{mqtt_ip}}">
+        <label for="mqtt_port">MQTT Port:</label>
+        <input class="w-100"  id="mqtt_port"  type="number" name="mqtt_port" min="1" max="65535" value="{{mqtt_port}}">
+        <label for="mqtt_user">MQTT User:</label>
+        <input class="w-100" id="mqtt_user" type="text" name="mqtt_user" value="{{mqtt_user}}">
+        <label for="mqtt_pass">MQTT Password:</label>
+        <input class="w-100" id="mqtt_pass" type="text" name="mqtt_pass" value="{{mqtt_pass}}">
+        <label for="client_id">MQTT Client ID:</label>
+        <input class="w-100" id="client_id" type="text" name="client_id" value="{{client_id}}">
+      </fieldset>
+      <fieldset>
+        <legend>Telemetry publishing</legend>
+        <label for="pub_dv">Voltage deadband (0.01 V):</label>
+        <input class="w-100" id="pub_dv" type="number" name="pub_dv" min="0" max="65535" value="{{pub_dv}}">
+        <label for="pub_dp">Percent deadband (%):</label>
+        <input class="w-100" id="pub_dp" type="number" name="pub_dp" min="0" max="100" value="{{pub_dp}}">
+        <label for="pub_silence">Max silence (s, 0 = off):</label>
+        <input class="w-100" id="pub_silence" type="number" name="pub_silence" min="0" max="65535" value="{{pub_silence}}">
+        <label for="pub_window">Coalescing window (ms, 0 = off):</label>
+        <input class="w-100" id="pub_window" type="number" name="pub_window" min="0" max="65535" value="{{pub_window}}">
+        <label for="pub_batch">Samples per batch frame (1 = off):</label>
+        <input class="w-100" id="pub_batch" type="number" name="pub_batch" min="1" max="16" value="{{pub_batch}}">
+        <label for="pub_flush">Batch flush interval (s):</label>
+        <input class="w-100" id="pub_flush" type="number" name="pub_flush" min="0" max="65535" value="{{pub_flush}}">
       </fieldset>
       <fieldset>
         <legend>Web interface settings</legend>
@@ -233,9 +119,19 @@ const char HTML_SETTINGS_HTML_END[] PROGMEM = R"=====(
   </body>
   </html>)=====";
 
+constexpr const char *SETTINGS_FIELDS[] = {
+    "mqtt_ip", "mqtt_port", "mqtt_user", "mqtt_pass", "client_id",
+    "pub_dv", "pub_dp", "pub_silence", "pub_window", "pub_batch", "pub_flush"};
+constexpr size_t SETTINGS_FIELD_COUNT = sizeof(SETTINGS_FIELDS) / sizeof(SETTINGS_FIELDS[0]);
+
+static_assert(PageTemplate::placeholderCount(HTML_SETTINGS_PAGE) == SETTINGS_FIELD_COUNT,
+              "HTML_SETTINGS_PAGE placeholders and SETTINGS_FIELDS differ");
+static_assert(PageTemplate::hasPlaceholders(HTML_SETTINGS_PAGE, SETTINGS_FIELDS, SETTINGS_FIELD_COUNT),
+              "HTML_SETTINGS_PAGE is missing a SETTINGS_FIELDS placeholder");
+
 const char STATUS_CONNECTED[] PROGMEM = "connected";
 const char STATUS_DISCONNECTED[] PROGMEM = "disconnected";
-const char MQTT_CONN_STATUS_JSON[] PROGMEM = R"({"mqtt":"%s"})";
+const char MQTT_CONN_STATUS_JSON[] PROGMEM = R"({"mqtt":"%s","retry":%u,"next_ms":%lu})";
 
 class HttpConfigServer
 {
@@ -244,14 +140,26 @@ private:
   char authUser[32] = {0};
   char authPass[32] = {0};
 
-  SoftwareSerial *loraSerial = nullptr;
+  static const uint8_t MAX_UNITS = 4;
+  XYCommandQueue *commandQueues[MAX_UNITS] = {};
+  const char *unitNames[MAX_UNITS] = {};
+  uint8_t unitCount = 0;
+  const TelemetryHistory *history = nullptr;
+  const LoopMetrics *metrics = nullptr;
+  EventStream events;
   bool isSerialDebug = false;
   bool mqttConnected = false;
+  uint16_t mqttRetry = 0;
+  uint32_t mqttNextMs = 0;
 
   std::function<void(const char *, const char *, const char *, const char *,
                      const char *, const char *, const char *)>
       saveCallback;
   std::function<void()> resetCredentialsCallback;
+  std::function<void(const PublishPolicyConfig &)> publishPolicyCallback;
+  std::function<void()> requestCallback;
+
+  PublishPolicyConfig _publishPolicy = DEFAULT_PUBLISH_POLICY;
 
   char _mqtt_ip[64] = {0};
   uint16_t _mqtt_port = 1883;
@@ -260,14 +168,21 @@ private:
   char _mqtt_pass[64] = {0};
   char _client_id[64] = {0};
 
-  void handleRoot();
+  void handleAsset(const WebAsset &asset);
   void handleSendCommand();
+  void handleCommandResult();
+  void handleHistory();
+  void handleMetrics();
+  void handleEvents();
   void handleConfigPage();
   void handleSaveConfig();
   void handleStatus();
+  // queue of the ?unit= argument, nullptr if there is no such unit
+  XYCommandQueue *requestedQueue();
+  // MQTT_CONN_STATUS_JSON with the current state
+  void formatMqttStatus(char *out, size_t size) const;
   void handleNotFound();
   bool isAuthorized();
-  void sendChunk(const char *data);
 
 public:
   HttpConfigServer(int port = 80,
@@ -279,15 +194,39 @@ public:
   void begin();
   void loop();
 
-  // MQTT - state setter
+  // MQTT - state setter (a change is pushed to /events)
   void setMqttConnected(bool state);
+  // failed reconnects in a row and the wait before the next one (pushed to /events)
+  void setMqttRetry(uint16_t attempt, uint32_t nextMs);
+
+  // live event for panels connected to /events (data must be one JSON line)
+  void pushEvent(const char *name, const char *data);
+  // skip building events nobody would receive
+  bool hasEventClients() const { return events.clients() > 0; }
 
   void setAuth(const char *user, const char *pwd);
 
-  void setLoraSerial(SoftwareSerial *serial);
+  // UART commands from /send go through this queue; with several XY-Lx0A
+  // units (multi-channel bridge) one per unit, /send?unit=<unit> picks it
+  // and the first one is the default
+  void addCommandQueue(XYCommandQueue *queue, const char *unit = "");
 
   void setIsSerialDebug(bool isDebug);
 
+  // samples served at /history
+  void setHistory(const TelemetryHistory *hist);
+
+  // runs at the start of every HTTP request (after the headers are parsed)
+  void onRequest(std::function<void()> cb);
+
+  // latency histograms served at /metrics (Prometheus text format)
+  void setMetrics(const LoopMetrics *loopMetrics);
+
+  // Telemetry publish policy shown/edited on the settings page,
+  // the callback runs before the save callback of the same form
+  void setPublishPolicy(const PublishPolicyConfig &cfg);
+  void onPublishPolicySave(std::function<void(const PublishPolicyConfig &)> cb);
+
   void setMQTT(const char *mqtt_ip, uint16_t mqtt_port,
                const char *mqtt_user, const char *mqtt_pass,
                const char *client_id);
@@ -0,0 +1,49 @@
+#include "JsonString.h"
+
+namespace
+{
+    // escaped form of c into esc (7 bytes), its length
+    size_t escapeOf(char c, char *esc)
+    {
+        if (c == '"' || c == '\\')
+        {
+            esc[0] = '\\';
+            esc[1] = c;
+            return 2;
+        }
+        if ((uint8_t)c < 0x20)
+            return snprintf_P(esc, 7, PSTR("\\u%04x"), c);
+        esc[0] = c;
+        return 1;
+    }
+}
+
+void writeJsonString(Print &out, const char *value)
+{
+    char esc[7];
+    out.write('"');
+    for (const char *p = value; *p; p++)
+        out.write(esc, escapeOf(*p, esc));
+    out.write('"');
+}
+
+size_t formatJsonString(char *out, size_t size, const char *value)
+{
+    char esc[7];
+    size_t len = 0;
+    if (size < 3)
+        return 0;
+    out[len++] = '"';
+    for (const char *p = value; *p; p++)
+    {
+        size_t n = escapeOf(*p, esc);
+        // room for the closing quote and the terminator
+        if (len + n + 2 > size)
+            return 0;
+        memcpy(out + len, esc, n);
+        len += n;
+    }
+    out[len++] = '"';
+    out[len] = '\0';
+    return len;
+}
@@ -0,0 +1,12 @@
+#ifndef JSON_STRING_H
+#define JSON_STRING_H
+
+#include <Arduino.h>
+
+// JSON string literals (quotes included) for values written with printf-style
+// formatting instead of ArduinoJson: `"`, `\` and control characters escaped.
+void writeJsonString(Print &out, const char *value);
+// the same into a buffer; returns the length, 0 if it does not fit
+size_t formatJsonString(char *out, size_t size, const char *value);
+
+#endif // JSON_STRING_H
@@ -0,0 +1,133 @@
+#include "LoopMetrics.h"
+
+const uint32_t LatencyHistogram::BOUNDS_US[LatencyHistogram::BUCKETS] = {
+    100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000,
+    100000, 250000, 1000000, 5000000};
+
+namespace
+{
+    const char *const STAGE_NAMES[METRIC_STAGE_COUNT] = {
+        "loop", "http", "uart", "mqtt", "mqtt_connect", "status", "outbox", "line_to_publish"};
+
+    // "0.000100" from 100 us, Prometheus wants seconds
+    void printSeconds(Print &out, uint64_t us)
+    {
+        out.printf_P(PSTR("%lu.%06lu"), (unsigned long)(us / 1000000), (unsigned long)(us % 1000000));
+    }
+}
+
+void LatencyHistogram::record(uint32_t us)
+{
+    uint8_t i = 0;
+    while (i < BUCKETS && us > BOUNDS_US[i])
+        i++;
+    counts[i]++;
+    count++;
+    sumUs += us;
+    if (us > maxUs)
+        maxUs = us;
+}
+
+void LoopMetrics::recordCycles(MetricStage stage, uint32_t cycles)
+{
+    recordUs(stage, cycles / ESP.getCpuFreqMHz());
+}
+
+void LoopMetrics::recordUs(MetricStage stage, uint32_t us)
+{
+    if (stage < METRIC_STAGE_COUNT)
+        stages[stage].record(us);
+}
+
+void LoopMetrics::recordDecode(uint32_t cycles, size_t bytes)
+{
+    decodeCycles += cycles;
+    decodeLines++;
+    decodeBytes += bytes;
+}
+
+uint32_t LoopMetrics::decodeNsPerLine() const
+{
+    if (decodeLines == 0)
+        return 0;
+    return (uint32_t)(decodeCycles * 1000 / ESP.getCpuFreqMHz() / decodeLines);
+}
+
+void LoopMetrics::loopTick()
+{
+    _loops++;
+    windowLoops++;
+
+    unsigned long elapsed = millis() - windowStart;
+    if (elapsed >= 1000)
+    {
+        _loopHz = (uint32_t)((uint64_t)windowLoops * 1000 / elapsed);
+        windowLoops = 0;
+        windowStart = millis();
+    }
+}
+
+const char *LoopMetrics::stageName(MetricStage stage)
+{
+    return stage < METRIC_STAGE_COUNT ? STAGE_NAMES[stage] : "unknown";
+}
+
+void LoopMetrics::writePrometheus(Print &out) const
+{
+    out.print(F("# HELP xy_stage_duration_seconds Time spent per loop stage\n"
+                "# TYPE xy_stage_duration_seconds histogram\n"));
+    for (uint8_t s = 0; s < METRIC_STAGE_COUNT; s++)
+    {
+        const LatencyHistogram &h = stages[s];
+        uint32_t cumulative = 0;
+        for (uint8_t i = 0; i <= LatencyHistogram::BUCKETS; i++)
+        {
+            cumulative += h.counts[i];
+            out.printf_P(PSTR("xy_stage_duration_seconds_bucket{stage=\"%s\",le=\""), STAGE_NAMES[s]);
+            if (i < LatencyHistogram::BUCKETS)
+                printSeconds(out, LatencyHistogram::BOUNDS_US[i]);
+            else
+                out.print(F("+Inf"));
+            out.printf_P(PSTR("\"} %lu\n"), (unsigned long)cumulative);
+        }
+        out.printf_P(PSTR("xy_stage_duration_seconds_sum{stage=\"%s\"} "), STAGE_NAMES[s]);
+        printSeconds(out, h.sumUs);
+        out.printf_P(PSTR("\nxy_stage_duration_seconds_count{stage=\"%s\"} %lu\n"),
+                     STAGE_NAMES[s], (unsigned long)h.count);
+    }
+
+    out.print(F("# HELP xy_stage_duration_max_seconds Longest single run since boot\n"
+                "# TYPE xy_stage_duration_max_seconds gauge\n"));
+    for (uint8_t s = 0; s < METRIC_STAGE_COUNT; s++)
+    {
+        out.printf_P(PSTR("xy_stage_duration_max_seconds{stage=\"%s\"} "), STAGE_NAMES[s]);
+        printSeconds(out, stages[s].maxUs);
+        out.print('\n');
+    }
+
+    // per-line decode cost is far below the histogram buckets, so it is
+    // exported as totals: rate(seconds) / rate(lines) is the time per line
+    out.print(F("# HELP xy_decode_seconds_total Time spent decoding UART lines\n"
+                "# TYPE xy_decode_seconds_total counter\n"
+                "xy_decode_seconds_total "));
+    printSeconds(out, decodeCycles / ESP.getCpuFreqMHz());
+    out.printf_P(PSTR("\n# HELP xy_decode_lines_total UART lines decoded\n"
+                      "# TYPE xy_decode_lines_total counter\n"
+                      "xy_decode_lines_total %lu\n"
+                      "# HELP xy_decode_bytes_total UART line bytes decoded\n"
+                      "# TYPE xy_decode_bytes_total counter\n"
+                      "xy_decode_bytes_total %lu\n"
+                      "# HELP xy_decode_line_nanoseconds Mean decode time per line since boot\n"
+                      "# TYPE xy_decode_line_nanoseconds gauge\n"
+                      "xy_decode_line_nanoseconds %lu\n"),
+                 (unsigned long)decodeLines, (unsigned long)decodeBytes,
+                 (unsigned long)decodeNsPerLine());
+
+    out.printf_P(PSTR("# HELP xy_loop_frequency_hz loop() iterations per second\n"
+                      "# TYPE xy_loop_frequency_hz gauge\n"
+                      "xy_loop_frequency_hz %lu\n"
+                      "# HELP xy_loops_total loop() iterations since boot\n"
+                      "# TYPE xy_loops_total counter\n"
+                      "xy_loops_total %lu\n"),
+                 (unsigned long)_loopHz, (unsigned long)_loops);
+}
@@ -0,0 +1,84 @@
+#ifndef LOOP_METRICS_H
+#define LOOP_METRICS_H
+
+#include <Arduino.h>
+
+enum MetricStage : uint8_t
+{
+    METRIC_LOOP = 0,        // one scheduler.run()
+    METRIC_HTTP,            // configServer.loop()
+    METRIC_UART,            // loraReader() + command queue
+    METRIC_MQTT,            // mqttClient.loop()
+    METRIC_MQTT_CONNECT,    // TLS + MQTT connect
+    METRIC_STATUS,          // publishStatus()
+    METRIC_OUTBOX,          // drainOutbox()
+    METRIC_LINE_TO_PUBLISH, // UART data line read -> MQTT publish
+    METRIC_STAGE_COUNT,
+};
+
+// Fixed-bucket latency histogram (microseconds)
+struct LatencyHistogram
+{
+    static const uint8_t BUCKETS = 13; // + the implicit +Inf bucket
+    static const uint32_t BOUNDS_US[BUCKETS];
+
+    uint32_t counts[BUCKETS + 1];
+    uint32_t count;
+    uint64_t sumUs;
+    uint32_t maxUs;
+
+    void record(uint32_t us);
+};
+
+// Loop instrumentation: stage durations from the CPU cycle counter,
+// loop frequency, exported as Prometheus text at /metrics.
+class LoopMetrics
+{
+public:
+    // times the enclosing block:
+    // { LoopMetrics::Scope scope(loopMetrics, METRIC_HTTP); ... }
+    class Scope
+    {
+    public:
+        Scope(LoopMetrics &metrics, MetricStage stage)
+            : metrics(metrics), stage(stage), start(ESP.getCycleCount()) {}
+        ~Scope() { metrics.recordCycles(stage, ESP.getCycleCount() - start); }
+
+    private:
+        LoopMetrics &metrics;
+        MetricStage stage;
+        uint32_t start;
+    };
+
+    void recordCycles(MetricStage stage, uint32_t cycles);
+    void recordUs(MetricStage stage, uint32_t us);
+
+    // one XYParser::classify() call over a line of `bytes` bytes
+    void recordDecode(uint32_t cycles, size_t bytes);
+    // mean decode time per line since boot
+    uint32_t decodeNsPerLine() const;
+
+    // once per loop(), updates the loop frequency every second
+    void loopTick();
+
+    const LatencyHistogram &histogram(MetricStage stage) const { return stages[stage]; }
+    uint32_t loopHz() const { return _loopHz; }
+    uint32_t loops() const { return _loops; }
+
+    static const char *stageName(MetricStage stage);
+
+    // Prometheus text exposition format 0.0.4
+    void writePrometheus(Print &out) const;
+
+private:
+    LatencyHistogram stages[METRIC_STAGE_COUNT] = {};
+    uint64_t decodeCycles = 0;
+    uint32_t decodeLines = 0;
+    uint32_t decodeBytes = 0;
+    uint32_t _loops = 0;
+    uint32_t _loopHz = 0;
+    uint32_t windowLoops = 0;
+    unsigned long windowStart = 0;
+};
+
+#endif // LOOP_METRICS_H
@@ -0,0 +1,96 @@
+#include "MqttTopics.h"
+
+namespace
+{
+    const char NAME_CMD[] PROGMEM = "cmd";
+    const char NAME_CMD_REPLY[] PROGMEM = "cmd/reply";
+    const char NAME_STATUS[] PROGMEM = "status";
+    const char NAME_STATUS_BIN[] PROGMEM = "status/bin";
+    const char NAME_BOOT[] PROGMEM = "boot";
+    const char NAME_METRICS[] PROGMEM = "metrics";
+    const char NAME_DATA[] PROGMEM = "data";
+    const char NAME_DATA_BATCH[] PROGMEM = "data/batch";
+    const char NAME_DATA_BIN[] PROGMEM = "data/bin";
+    const char NAME_CONFIG[] PROGMEM = "config";
+    const char NAME_RAW[] PROGMEM = "raw";
+    const char NAME_REPLY[] PROGMEM = "reply";
+
+    const char *const DEVICE_NAMES[MQTT_TOPIC_COUNT] = {
+        NAME_CMD, NAME_CMD_REPLY, NAME_STATUS, NAME_STATUS_BIN, NAME_BOOT, NAME_METRICS,
+        NAME_DATA, NAME_DATA_BATCH, NAME_DATA_BIN, NAME_CONFIG, NAME_RAW, NAME_REPLY};
+
+    // shared flat topics cannot tell devices apart by name
+    inline bool flatNeedsId(uint8_t topic)
+    {
+        return topic == MQTT_TOPIC_STATUS_BIN || topic == MQTT_TOPIC_DATA_BIN;
+    }
+
+    // "xy/{id}" -> "xy/<client_id>", false if it does not fit
+    bool expandPrefix(const char *prefix, const char *clientId, char *out, size_t size)
+    {
+        size_t used = 0;
+        size_t idLen = strlen(clientId);
+        while (*prefix)
+        {
+            if (strncmp(prefix, "{id}", 4) == 0)
+            {
+                if (used + idLen >= size)
+                    return false;
+                memcpy(out + used, clientId, idLen);
+                used += idLen;
+                prefix += 4;
+                continue;
+            }
+            if (used + 1 >= size)
+                return false;
+            out[used++] = *prefix++;
+        }
+        out[used] = '\0';
+        return used > 0;
+    }
+}
+
+bool MqttTopics::build(const char *clientId, const char *prefix, const char *const *flatNames, bool flat)
+{
+    if (!flat && buildDevice(clientId, prefix))
+        return true;
+
+    buildFlat(clientId, flatNames);
+    return flat;
+}
+
+bool MqttTopics::buildDevice(const char *clientId, const char *prefix)
+{
+    char expanded[96];
+    if (!expandPrefix(prefix, clientId, expanded, sizeof(expanded)))
+        return false;
+
+    size_t used = 0;
+    for (uint8_t t = 0; t < MQTT_TOPIC_COUNT; t++)
+    {
+        int len = snprintf_P(pool + used, POOL_SIZE - used, PSTR("%s/%S"), expanded, DEVICE_NAMES[t]);
+        if (len < 0 || (size_t)len >= POOL_SIZE - used)
+            return false;
+        offsets[t] = used;
+        used += len + 1;
+    }
+    _flat = false;
+    return true;
+}
+
+bool MqttTopics::buildFlat(const char *clientId, const char *const *flatNames)
+{
+    size_t used = 0;
+    for (uint8_t t = 0; t < MQTT_TOPIC_COUNT; t++)
+    {
+        int len = flatNeedsId(t)
+                      ? snprintf_P(pool + used, POOL_SIZE - used, PSTR("%S/%s"), flatNames[t], clientId)
+                      : snprintf_P(pool + used, POOL_SIZE - used, PSTR("%S"), flatNames[t]);
+        if (len < 0 || (size_t)len >= POOL_SIZE - used)
+            return false;
+        offsets[t] = used;
+        used += len + 1;
+    }
+    _flat = true;
+    return true;
+}
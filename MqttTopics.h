@@ -0,0 +1,52 @@
+#ifndef MQTT_TOPICS_H
+#define MQTT_TOPICS_H
+
+#include <Arduino.h>
+
+enum MqttTopic : uint8_t
+{
+    MQTT_TOPIC_CMD = 0,    // in: commands
+    MQTT_TOPIC_CMD_REPLY,  // command results
+    MQTT_TOPIC_STATUS,     // heartbeat, also the Last Will
+    MQTT_TOPIC_STATUS_BIN, // heartbeat, MessagePack
+    MQTT_TOPIC_BOOT,       // boot phase timing
+    MQTT_TOPIC_METRICS,    // loop latency summary
+    MQTT_TOPIC_DATA,       // XY-L30A data sample
+    MQTT_TOPIC_DATA_BATCH, // batched samples
+    MQTT_TOPIC_DATA_BIN,   // data sample, MessagePack
+    MQTT_TOPIC_CONFIG,     // XY-L30A config echo
+    MQTT_TOPIC_RAW,        // other UART lines
+    MQTT_TOPIC_REPLY,      // reply to uart_send
+    MQTT_TOPIC_COUNT,
+};
+
+// All MQTT topic names of this device, built once (at boot and on each
+// connect) instead of formatted on every publish.
+//  - per device: "<prefix>/<name>", "{id}" in the prefix is the client id,
+//    e.g. "xy/{id}" -> xy/<client_id>/cmd, xy/<client_id>/data, ...
+//  - flat (compat): the shared topics from config.h, e.g. device/command,
+//    esp/data; MessagePack topics get "/<client_id>" as before
+class MqttTopics
+{
+public:
+    static const size_t POOL_SIZE = 768;
+    // buffer for one topic plus a "/<unit>" suffix (multi-channel bridge)
+    static const size_t MAX_TOPIC_SIZE = 128;
+
+    // flatNames[MQTT_TOPIC_COUNT] are PROGMEM strings; false (and flat
+    // topics) if the per-device names do not fit the pool
+    bool build(const char *clientId, const char *prefix, const char *const *flatNames, bool flat);
+
+    const char *get(MqttTopic topic) const { return pool + offsets[topic]; }
+    bool flat() const { return _flat; }
+
+private:
+    char pool[POOL_SIZE] = {0};
+    uint16_t offsets[MQTT_TOPIC_COUNT] = {};
+    bool _flat = true;
+
+    bool buildDevice(const char *clientId, const char *prefix);
+    bool buildFlat(const char *clientId, const char *const *flatNames);
+};
+
+#endif // MQTT_TOPICS_H
@@ -0,0 +1,108 @@
+#include "PageTemplate.h"
+
+namespace
+{
+    const char *escapeOf(char c)
+    {
+        switch (c)
+        {
+        case '&':
+            return "&amp;";
+        case '<':
+            return "&lt;";
+        case '>':
+            return "&gt;";
+        case '"':
+            return "&quot;";
+        case '\'':
+            return "&#39;";
+        default:
+            return nullptr;
+        }
+    }
+}
+
+size_t PageTemplate::length() const
+{
+    return walk(nullptr);
+}
+
+void PageTemplate::render(Print &out) const
+{
+    walk(&out);
+}
+
+size_t PageTemplate::escapedLength(const char *value)
+{
+    size_t len = 0;
+    for (const char *p = value; *p; p++)
+    {
+        const char *esc = escapeOf(*p);
+        len += esc ? strlen(esc) : 1;
+    }
+    return len;
+}
+
+void PageTemplate::writeEscaped(Print &out, const char *value)
+{
+    for (const char *p = value; *p; p++)
+    {
+        const char *esc = escapeOf(*p);
+        if (esc)
+            out.print(esc);
+        else
+            out.write(*p);
+    }
+}
+
+const char *PageTemplate::lookup(const char *name) const
+{
+    for (uint8_t i = 0; i < varCount; i++)
+    {
+        if (strcmp(vars[i].name, name) == 0)
+            return vars[i].value ? vars[i].value : "";
+    }
+    return "";
+}
+
+size_t PageTemplate::walk(Print *out) const
+{
+    size_t total = 0;
+
+    for (uint8_t part = 0; part < partCount; part++)
+    {
+        const char *p = parts[part];
+        char c;
+        while ((c = pgm_read_byte(p)) != '\0')
+        {
+            if (c != '{' || pgm_read_byte(p + 1) != '{')
+            {
+                if (out)
+                    out->write(c);
+                total++;
+                p++;
+                continue;
+            }
+
+            // {{name}}
+            p += 2;
+            char name[MAX_NAME];
+            uint8_t n = 0;
+            while ((c = pgm_read_byte(p)) != '\0' && c != '}')
+            {
+                if (n < sizeof(name) - 1)
+                    name[n++] = c;
+                p++;
+            }
+            name[n] = '\0';
+            while (pgm_read_byte(p) == '}')
+                p++;
+
+            const char *value = lookup(name);
+            if (out)
+                writeEscaped(*out, value);
+            total += escapedLength(value);
+        }
+    }
+    return total;
+}
@@ -0,0 +1,85 @@
+#ifndef PAGE_TEMPLATE_H
+#define PAGE_TEMPLATE_H
+
+#include <Arduino.h>
+
+// value for a {{name}} placeholder, HTML-escaped on output
+struct TemplateVar
+{
+    const char *name;
+    const char *value;
+};
+
+// Renders PROGMEM pages with {{name}} placeholders.
+// length() walks the template once to get the exact Content-Length,
+// render() writes it to a Print (a coalescing buffer in HttpConfigServer).
+// The constexpr helpers let a page be checked against its fields at compile time:
+//   static_assert(PageTemplate::placeholderCount(PAGE) == FIELD_COUNT, "...");
+class PageTemplate
+{
+public:
+    static const uint8_t MAX_NAME = 24;
+
+    // parts are rendered back to back (e.g. a shared header + the page)
+    PageTemplate(const char *const *parts, uint8_t partCount,
+                 const TemplateVar *vars, uint8_t varCount)
+        : parts(parts), partCount(partCount), vars(vars), varCount(varCount) {}
+
+    size_t length() const;
+    void render(Print &out) const;
+
+    static size_t escapedLength(const char *value);
+    static void writeEscaped(Print &out, const char *value);
+
+    static constexpr size_t placeholderCount(const char *tpl)
+    {
+        size_t count = 0;
+        for (size_t i = 0; tpl[i] && tpl[i + 1]; i++)
+        {
+            if (tpl[i] == '{' && tpl[i + 1] == '{')
+            {
+                count++;
+                i++;
+            }
+        }
+        return count;
+    }
+
+    static constexpr bool hasPlaceholder(const char *tpl, const char *name)
+    {
+        for (size_t i = 0; tpl[i] && tpl[i + 1]; i++)
+        {
+            if (tpl[i] != '{' || tpl[i + 1] != '{')
+                continue;
+            size_t n = 0;
+            while (name[n] && tpl[i + 2 + n] == name[n])
+                n++;
+            if (!name[n] && tpl[i + 2 + n] == '}')
+                return true;
+        }
+        return false;
+    }
+
+    static constexpr bool hasPlaceholders(const char *tpl, const char *const *names, size_t count)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            if (!hasPlaceholder(tpl, names[i]))
+                return false;
+        }
+        return true;
+    }
+
+private:
+    const char *const *parts;
+    uint8_t partCount;
+    const TemplateVar *vars;
+    uint8_t varCount;
+
+    // walks all parts: literal runs go to out (if any), placeholders are
+    // escaped into out; returns the rendered length
+    size_t walk(Print *out) const;
+    const char *lookup(const char *name) const;
+};
+
+#endif // PAGE_TEMPLATE_H
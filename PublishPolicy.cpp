@@ -0,0 +1,134 @@
+#include "PublishPolicy.h"
+
+namespace
+{
+    inline uint16_t distance(int a, int b)
+    {
+        return a > b ? a - b : b - a;
+    }
+
+    // a deadband of 0 triggers on any change
+    inline bool exceeds(uint16_t delta, uint16_t deadband)
+    {
+        return delta > 0 && delta >= deadband;
+    }
+}
+
+void PublishPolicy::setConfig(const PublishPolicyConfig &cfg)
+{
+    _config = cfg;
+}
+
+bool PublishPolicy::crossesDeadband(const XYPacket &packet) const
+{
+    return exceeds(distance(packet.centivolts, last.centivolts), _config.voltageDeadband) ||
+           exceeds(distance(packet.percent, last.percent), _config.percentDeadband);
+}
+
+void PublishPolicy::markPublished(const XYPacket &packet, unsigned long now)
+{
+    last = packet;
+    hasLast = true;
+    hasPending = false;
+    lastPublishedAt = now;
+}
+
+bool PublishPolicy::offer(const XYPacket &packet, unsigned long now)
+{
+    bool stateChanged = hasLast && strcmp(packet.state, last.state) != 0;
+    bool silenceExpired = _config.maxSilenceSec > 0 &&
+                          now - lastPublishedAt >= (unsigned long)_config.maxSilenceSec * 1000;
+
+    if (!hasLast || stateChanged || silenceExpired)
+    {
+        markPublished(packet, now);
+        return true;
+    }
+
+    if (hasPending)
+    {
+        // inside the window: keep the freshest sample
+        pending = packet;
+        return false;
+    }
+
+    if (!crossesDeadband(packet))
+    {
+        _suppressed++;
+        return false;
+    }
+
+    if (_config.coalesceMs == 0)
+    {
+        markPublished(packet, now);
+        return true;
+    }
+
+    pending = packet;
+    hasPending = true;
+    windowStart = now;
+    return false;
+}
+
+bool PublishPolicy::poll(XYPacket &out, unsigned long now)
+{
+    if (!hasPending || now - windowStart < _config.coalesceMs)
+        return false;
+
+    out = pending;
+    markPublished(pending, now);
+    return true;
+}
+
+void PublishPolicy::reset()
+{
+    hasLast = false;
+    hasPending = false;
+}
+
+bool PublishPolicy::parseConfig(const char *spec, PublishPolicyConfig &cfg)
+{
+    if (!spec)
+        return false;
+
+    bool any = false;
+    const char *p = spec;
+    while (*p)
+    {
+        const char *key = p;
+        while (*p && *p != '=' && *p != ',')
+            p++;
+        size_t keyLen = p - key;
+        if (*p != '=')
+            return false;
+        p++;
+
+        char *end = nullptr;
+        unsigned long value = strtoul(p, &end, 10);
+        if (end == p)
+            return false;
+        p = end;
+
+        if (keyLen == 2 && strncmp(key, "dv", 2) == 0 && value <= 0xFFFF)
+            cfg.voltageDeadband = value;
+        else if (keyLen == 2 && strncmp(key, "dp", 2) == 0 && value <= 100)
+            cfg.percentDeadband = value;
+        else if (keyLen == 7 && strncmp(key, "silence", 7) == 0 && value <= 0xFFFF)
+            cfg.maxSilenceSec = value;
+        else if (keyLen == 6 && strncmp(key, "window", 6) == 0 && value <= 0xFFFF)
+            cfg.coalesceMs = value;
+        else if (keyLen == 5 && strncmp(key, "batch", 5) == 0 && value <= 16)
+            cfg.batchSize = value;
+        else if (keyLen == 5 && strncmp(key, "flush", 5) == 0 && value <= 0xFFFF)
+            cfg.batchFlushSec = value;
+        else
+            return false;
+        any = true;
+
+        if (*p == ',')
+            p++;
+        else if (*p)
+            return false;
+    }
+    return any;
+}
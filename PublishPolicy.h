@@ -0,0 +1,62 @@
+#ifndef PUBLISH_POLICY_H
+#define PUBLISH_POLICY_H
+
+#include <Arduino.h>
+#include "XYParser.h"
+
+struct PublishPolicyConfig
+{
+    uint16_t voltageDeadband; // 0.01V, 0 = any change
+    uint8_t percentDeadband;  // %, 0 = any change
+    uint16_t maxSilenceSec;   // publish at least this often, 0 = never forced
+    uint16_t coalesceMs;      // samples inside the window are merged, 0 = off
+    uint8_t batchSize;        // samples per esp/data/batch frame, <= 1 = off
+    uint16_t batchFlushSec;   // max age of a batch frame, 0 = only when full
+};
+
+const PublishPolicyConfig DEFAULT_PUBLISH_POLICY = {5, 1, 60, 1000, 1, 30};
+
+// Decides which XY-L30A data samples go to esp/data:
+// a sample is published when a deadband is crossed, the state changes
+// or maxSilenceSec expires. Samples crossing a deadband open a coalescing
+// window, the last sample of the window is published when it closes.
+// State changes are published at once.
+class PublishPolicy
+{
+public:
+    void setConfig(const PublishPolicyConfig &cfg);
+    const PublishPolicyConfig &config() const { return _config; }
+
+    // true if `packet` must be published now
+    bool offer(const XYPacket &packet, unsigned long now);
+
+    // true (and `out` is set) when a coalescing window closes
+    bool poll(XYPacket &out, unsigned long now);
+
+    // next sample is published unconditionally (e.g. after MQTT reconnect)
+    void reset();
+
+    uint32_t suppressed() const { return _suppressed; }
+
+    // "dv=5,dp=1,silence=60,window=1000,batch=8,flush=30",
+    // only the given keys are changed
+    static bool parseConfig(const char *spec, PublishPolicyConfig &cfg);
+
+private:
+    PublishPolicyConfig _config = DEFAULT_PUBLISH_POLICY;
+
+    XYPacket last = {};
+    bool hasLast = false;
+    unsigned long lastPublishedAt = 0;
+
+    XYPacket pending = {};
+    bool hasPending = false;
+    unsigned long windowStart = 0;
+
+    uint32_t _suppressed = 0;
+
+    bool crossesDeadband(const XYPacket &packet) const;
+    void markPublished(const XYPacket &packet, unsigned long now);
+};
+
+#endif // PUBLISH_POLICY_H
@@ -0,0 +1,57 @@
+#include "ReconnectBackoff.h"
+
+void ReconnectBackoff::begin(uint32_t baseMs, uint32_t capMs, uint32_t seed)
+{
+    base = baseMs ? baseMs : 1;
+    cap = capMs > base ? capMs : base;
+    rng = seed ? seed : 1;
+}
+
+bool ReconnectBackoff::due(unsigned long now)
+{
+    if (!pending)
+    {
+        schedule(now, random(base + 1));
+        return false;
+    }
+    return (long)(now - nextAt) >= 0;
+}
+
+void ReconnectBackoff::failed(unsigned long now)
+{
+    _stats.failures++;
+    if (_stats.attempt < UINT16_MAX)
+        _stats.attempt++;
+
+    // base * 2^attempt without overflowing
+    uint32_t ceiling = base;
+    for (uint16_t i = 0; i < _stats.attempt && ceiling < cap; i++)
+        ceiling = ceiling > cap / 2 ? cap : ceiling * 2;
+
+    schedule(now, ceiling / 2 + random(ceiling / 2 + 1));
+}
+
+void ReconnectBackoff::succeeded()
+{
+    _stats.connects++;
+    _stats.lastRetries = _stats.attempt;
+    _stats.attempt = 0;
+    _stats.nextDelayMs = 0;
+    pending = false;
+}
+
+void ReconnectBackoff::schedule(unsigned long now, uint32_t delayMs)
+{
+    pending = true;
+    nextAt = now + delayMs;
+    _stats.nextDelayMs = delayMs;
+}
+
+// xorshift32, 0..range-1
+uint32_t ReconnectBackoff::random(uint32_t range)
+{
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng % range;
+}
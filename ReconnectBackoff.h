@@ -0,0 +1,45 @@
+#ifndef RECONNECT_BACKOFF_H
+#define RECONNECT_BACKOFF_H
+
+#include <Arduino.h>
+
+struct ReconnectStats
+{
+    uint32_t connects;    // successful connects since boot
+    uint32_t failures;    // failed attempts since boot
+    uint16_t attempt;     // failed attempts since the last connect
+    uint16_t lastRetries; // failed attempts before the last connect
+    uint32_t nextDelayMs; // wait before the pending attempt, 0 if connected
+};
+
+// Jittered exponential backoff for broker reconnects:
+// the n-th retry waits a random time in [d/2, d], d = min(cap, base * 2^n),
+// and even the first attempt after a connection loss waits a random
+// [0, base], so a fleet that lost its broker at the same moment does not
+// come back in lockstep. The random sequence is seeded per device.
+class ReconnectBackoff
+{
+public:
+    void begin(uint32_t baseMs, uint32_t capMs, uint32_t seed);
+
+    // true when the next attempt may run; the first call after a
+    // connection loss only schedules it
+    bool due(unsigned long now);
+    void failed(unsigned long now);
+    void succeeded();
+
+    const ReconnectStats &stats() const { return _stats; }
+
+private:
+    uint32_t base = 1000;
+    uint32_t cap = 60000;
+    uint32_t rng = 1;
+    bool pending = false; // an attempt is scheduled
+    unsigned long nextAt = 0;
+    ReconnectStats _stats = {0, 0, 0, 0, 0};
+
+    void schedule(unsigned long now, uint32_t delayMs);
+    uint32_t random(uint32_t range);
+};
+
+#endif // RECONNECT_BACKOFF_H
@@ -0,0 +1,50 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <Arduino.h>
+
+// Lock-free single-producer/single-consumer ring.
+// The producer only writes `head`, the consumer only writes `tail`,
+// so push() may run from the receive path while pop() runs in loop().
+template <typename T, uint16_t SIZE>
+class SpscRing
+{
+    static_assert(SIZE > 0 && (SIZE & (SIZE - 1)) == 0, "SIZE must be a power of two");
+
+public:
+    bool push(const T &item)
+    {
+        uint16_t h = head;
+        if ((uint16_t)(h - tail) == SIZE)
+            return false;
+        buffer[h & (SIZE - 1)] = item;
+        barrier();
+        head = h + 1;
+        return true;
+    }
+
+    bool pop(T &item)
+    {
+        uint16_t t = tail;
+        if (t == head)
+            return false;
+        item = buffer[t & (SIZE - 1)];
+        barrier();
+        tail = t + 1;
+        return true;
+    }
+
+    uint16_t size() const { return (uint16_t)(head - tail); }
+    bool empty() const { return head == tail; }
+    bool full() const { return size() == SIZE; }
+    static constexpr uint16_t capacity() { return SIZE; }
+
+private:
+    static inline void barrier() { __asm__ __volatile__("" ::: "memory"); }
+
+    T buffer[SIZE];
+    volatile uint16_t head = 0;
+    volatile uint16_t tail = 0;
+};
+
+#endif // SPSC_RING_H
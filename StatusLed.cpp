@@ -0,0 +1,38 @@
+#include "StatusLed.h"
+
+void StatusLed::begin(uint8_t pin)
+{
+    _pin = pin;
+    pinMode(_pin, OUTPUT);
+    write(false);
+}
+
+void StatusLed::blink(uint16_t periodMs, uint16_t num)
+{
+    period = periodMs;
+    toggles = (uint32_t)num * 2;
+    if (toggles == 0)
+    {
+        write(false);
+        return;
+    }
+    write(true);
+    toggles--;
+    lastToggle = millis();
+}
+
+void StatusLed::tick()
+{
+    if (toggles == 0 || millis() - lastToggle < period)
+        return;
+
+    lastToggle = millis();
+    write(!on);
+    toggles--;
+}
+
+void StatusLed::write(bool state)
+{
+    on = state;
+    digitalWrite(_pin, state ? LOW : HIGH); // LOW — active level for ESP
+}
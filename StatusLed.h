@@ -0,0 +1,29 @@
+#ifndef STATUS_LED_H
+#define STATUS_LED_H
+
+#include <Arduino.h>
+
+// Non-blocking blink patterns for the built-in LED (active LOW):
+// blink() only queues the pattern, tick() switches the pin when due.
+class StatusLed
+{
+public:
+    void begin(uint8_t pin);
+
+    // num on/off cycles of periodMs each; replaces a running pattern
+    void blink(uint16_t periodMs, uint16_t num = 1);
+    bool busy() const { return toggles > 0; }
+
+    void tick();
+
+private:
+    uint8_t _pin = LED_BUILTIN;
+    uint16_t period = 0;
+    uint32_t toggles = 0; // remaining pin changes
+    unsigned long lastToggle = 0;
+    bool on = false;
+
+    void write(bool state);
+};
+
+#endif // STATUS_LED_H
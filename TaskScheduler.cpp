@@ -0,0 +1,100 @@
+#include "TaskScheduler.h"
+
+uint8_t TaskScheduler::every(const char *name, uint32_t intervalMs, uint32_t budgetUs, TaskFn fn)
+{
+    return add(name, intervalMs, 0, budgetUs, false, fn);
+}
+
+uint8_t TaskScheduler::after(const char *name, uint32_t delayMs, uint32_t budgetUs, TaskFn fn)
+{
+    return add(name, 0, delayMs, budgetUs, true, fn);
+}
+
+uint8_t TaskScheduler::add(const char *name, uint32_t intervalMs, uint32_t delayMs,
+                           uint32_t budgetUs, bool oneShot, TaskFn fn)
+{
+    for (uint8_t i = 0; i < MAX_TASKS; i++)
+    {
+        SchedulerTask &t = tasks[i];
+        if (t.fn)
+            continue;
+
+        t = SchedulerTask();
+        t.name = name;
+        t.fn = fn;
+        t.intervalMs = intervalMs;
+        t.budgetUs = budgetUs;
+        t.nextRun = millis() + delayMs;
+        t.enabled = true;
+        t.oneShot = oneShot;
+        return i;
+    }
+    return NO_TASK;
+}
+
+void TaskScheduler::between(TaskFn fn)
+{
+    betweenFn = fn;
+}
+
+void TaskScheduler::trigger(uint8_t id, uint32_t delayMs)
+{
+    if (id < MAX_TASKS && tasks[id].fn)
+        tasks[id].nextRun = millis() + delayMs;
+}
+
+void TaskScheduler::setInterval(uint8_t id, uint32_t intervalMs)
+{
+    if (id < MAX_TASKS && tasks[id].fn)
+        tasks[id].intervalMs = intervalMs;
+}
+
+void TaskScheduler::setEnabled(uint8_t id, bool enabled)
+{
+    if (id < MAX_TASKS && tasks[id].fn)
+        tasks[id].enabled = enabled;
+}
+
+const SchedulerTask *TaskScheduler::task(uint8_t id) const
+{
+    return id < MAX_TASKS && tasks[id].fn ? &tasks[id] : nullptr;
+}
+
+void TaskScheduler::run()
+{
+    for (uint8_t i = 0; i < MAX_TASKS; i++)
+    {
+        SchedulerTask &t = tasks[i];
+        // wrap-safe: due once nextRun is not in the future
+        if (!t.fn || !t.enabled || (int32_t)(millis() - t.nextRun) < 0)
+            continue;
+
+        uint32_t start = micros();
+        t.fn();
+        uint32_t elapsed = micros() - start;
+
+        t.runs++;
+        if (elapsed > t.maxUs)
+            t.maxUs = elapsed;
+        if (t.budgetUs && elapsed > t.budgetUs)
+        {
+            t.overruns++;
+            _overruns++;
+        }
+
+        if (t.oneShot)
+        {
+            t.fn = nullptr;
+        }
+        else
+        {
+            // a late task is not run back-to-back to catch up
+            t.nextRun += t.intervalMs;
+            if ((int32_t)(millis() - t.nextRun) >= 0)
+                t.nextRun = millis() + t.intervalMs;
+        }
+
+        if (betweenFn)
+            betweenFn();
+    }
+}
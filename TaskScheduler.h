@@ -0,0 +1,60 @@
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <Arduino.h>
+#include <functional>
+
+struct SchedulerTask
+{
+    const char *name;
+    std::function<void()> fn;
+    uint32_t intervalMs; // 0 = every run()
+    uint32_t budgetUs;   // a longer run counts as an overrun
+    uint32_t nextRun;
+    uint32_t runs;
+    uint32_t overruns;
+    uint32_t maxUs; // longest single run
+    bool enabled;
+    bool oneShot; // slot is freed after the first run
+};
+
+// Cooperative scheduler over a static task table, driven from loop():
+// tasks never block, each run is timed against its budget and the
+// between() hook (UART pump) runs after every task, so one slow step
+// cannot starve ingestion.
+class TaskScheduler
+{
+public:
+    static const uint8_t MAX_TASKS = 14;
+    static const uint8_t NO_TASK = 0xFF;
+
+    typedef std::function<void()> TaskFn;
+
+    // periodic task, first run on the next run() call; returns NO_TASK if the table is full
+    uint8_t every(const char *name, uint32_t intervalMs, uint32_t budgetUs, TaskFn fn);
+    // one-shot task, runs once after delayMs
+    uint8_t after(const char *name, uint32_t delayMs, uint32_t budgetUs, TaskFn fn);
+
+    void between(TaskFn fn);
+
+    // next run in delayMs (keeps the interval)
+    void trigger(uint8_t id, uint32_t delayMs = 0);
+    void setInterval(uint8_t id, uint32_t intervalMs);
+    void setEnabled(uint8_t id, bool enabled);
+
+    void run();
+
+    // nullptr for a free slot
+    const SchedulerTask *task(uint8_t id) const;
+    uint32_t overruns() const { return _overruns; }
+
+private:
+    SchedulerTask tasks[MAX_TASKS] = {};
+    TaskFn betweenFn;
+    uint32_t _overruns = 0;
+
+    uint8_t add(const char *name, uint32_t intervalMs, uint32_t delayMs,
+                uint32_t budgetUs, bool oneShot, TaskFn fn);
+};
+
+#endif // TASK_SCHEDULER_H
@@ -0,0 +1,95 @@
+#include "TelemetryBatcher.h"
+#include "JsonString.h"
+
+void TelemetryBatcher::configure(uint8_t size, uint16_t intervalSec)
+{
+    _size = size > MAX_SAMPLES ? MAX_SAMPLES : size;
+    _intervalSec = intervalSec;
+}
+
+bool TelemetryBatcher::add(const XYPacket &packet, unsigned long now)
+{
+    if (_count == 0)
+    {
+        firstAt = now;
+        baseTime = time(nullptr);
+    }
+    else if (_count >= _size)
+    {
+        // not flushed (MQTT down): keep the newest samples
+        memmove(&samples[0], &samples[1], sizeof(Sample) * (_count - 1));
+        _count--;
+        _dropped++;
+    }
+
+    bool stateChanged = _count > 0 &&
+                        strcmp(samples[_count - 1].packet.state, packet.state) != 0;
+
+    samples[_count].offsetMs = now - firstAt;
+    samples[_count].packet = packet;
+    _count++;
+
+    return stateChanged || _count >= _size;
+}
+
+bool TelemetryBatcher::due(unsigned long now) const
+{
+    return _count > 0 && _intervalSec > 0 &&
+           now - firstAt >= (unsigned long)_intervalSec * 1000;
+}
+
+size_t TelemetryBatcher::serialize(char *out, size_t size, const char *deviceId, const char *unit) const
+{
+    if (_count == 0)
+        return 0;
+
+    // a batch started before NTP answered is rebased once time is valid
+    time_t ts = baseTime;
+    if (!unixTimeValid(ts))
+    {
+        time_t now = time(nullptr);
+        ts = unixTimeValid(now) ? now - (time_t)((millis() - firstAt) / 1000) : 0;
+    }
+    char tsField[24];
+    if (ts)
+        snprintf_P(tsField, sizeof(tsField), PSTR("\"ts\":%lu"), (unsigned long)ts);
+    else
+        strcpy_P(tsField, PSTR("\"ts_valid\":false"));
+
+    // the strings are escaped, a client id may hold quotes or backslashes
+    size_t len = 0;
+    if (!fits(len, size, snprintf_P(out, size, PSTR("{\"type\":\"batch\",\"device_id\":"))) ||
+        !fits(len, size, formatJsonString(out + len, size - len, deviceId)))
+        return 0;
+    if (unit && *unit &&
+        (!fits(len, size, snprintf_P(out + len, size - len, PSTR(",\"unit\":"))) ||
+         !fits(len, size, formatJsonString(out + len, size - len, unit))))
+        return 0;
+    if (!fits(len, size, snprintf_P(out + len, size - len, PSTR(",%s,\"samples\":["), tsField)))
+        return 0;
+
+    for (uint8_t i = 0; i < _count; ++i)
+    {
+        const XYPacket &p = samples[i].packet;
+        char state[16];
+        formatJsonString(state, sizeof(state), p.state);
+        if (!fits(len, size, snprintf_P(out + len, size - len, PSTR("%s[%lu,%u.%02u,%d,\"%02d:%02d\",%s]"),
+                                        i ? "," : "", (unsigned long)samples[i].offsetMs,
+                                        p.centivolts / 100, p.centivolts % 100,
+                                        p.percent, p.hours, p.minutes, state)))
+            return 0;
+    }
+
+    if (!fits(len, size, snprintf_P(out + len, size - len, PSTR("]}"))))
+        return 0;
+    return len;
+}
+
+bool TelemetryBatcher::fits(size_t &len, size_t size, int written)
+{
+    // snprintf: negative or cut; formatJsonString: 0 if it did not fit
+    if (written <= 0 || (size_t)written >= size - len)
+        return false;
+    len += written;
+    return true;
+}
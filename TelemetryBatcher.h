@@ -0,0 +1,56 @@
+#ifndef TELEMETRY_BATCHER_H
+#define TELEMETRY_BATCHER_H
+
+#include <Arduino.h>
+#include <time.h>
+#include "XYParser.h"
+#include "UnixTime.h"
+
+// Collects XY-L30A data samples into one MQTT frame:
+// {"type":"batch","device_id":"..",["unit":"..",]"ts":<unix time of first sample>,
+//  "samples":[[<ms since first>,<voltage>,<percent>,"hh:mm","ST"],...]}
+// Without NTP time yet, "ts" is replaced by "ts_valid":false.
+// The frame is flushed when `size` samples are collected, `intervalSec`
+// passed since the first one, or the state changes.
+class TelemetryBatcher
+{
+public:
+    static const uint8_t MAX_SAMPLES = 16;
+
+    // size <= 1 disables batching
+    void configure(uint8_t size, uint16_t intervalSec);
+    bool enabled() const { return _size > 1; }
+
+    // true if the batch must be flushed now
+    bool add(const XYPacket &packet, unsigned long now);
+    bool due(unsigned long now) const;
+
+    // writes the frame to `out`, returns its length (0 if empty or too small);
+    // `unit` (multi-channel bridge) is added after device_id when set
+    size_t serialize(char *out, size_t size, const char *deviceId, const char *unit = nullptr) const;
+    void clear() { _count = 0; }
+
+    uint8_t count() const { return _count; }
+    uint32_t dropped() const { return _dropped; }
+
+private:
+    struct Sample
+    {
+        uint32_t offsetMs;
+        XYPacket packet;
+    };
+
+    Sample samples[MAX_SAMPLES];
+    uint8_t _count = 0;
+    uint8_t _size = 1;
+    uint16_t _intervalSec = 0;
+
+    unsigned long firstAt = 0;
+    time_t baseTime = 0;
+    uint32_t _dropped = 0;
+
+    // adds a snprintf_P/formatJsonString result to len, false if it did not fit
+    static bool fits(size_t &len, size_t size, int written);
+};
+
+#endif // TELEMETRY_BATCHER_H
@@ -0,0 +1,207 @@
+#include "TelemetryEncoding.h"
+
+namespace
+{
+    // Minimal MessagePack writer for the fixed schemas above
+    class MsgPackWriter
+    {
+    public:
+        MsgPackWriter(uint8_t *out, size_t size) : out(out), size(size) {}
+
+        void array(uint8_t count) { byte(0x90 | (count & 0x0F)); }
+
+        void uint(uint32_t v)
+        {
+            if (v < 0x80)
+            {
+                byte(v);
+            }
+            else if (v <= 0xFF)
+            {
+                byte(0xCC);
+                byte(v);
+            }
+            else if (v <= 0xFFFF)
+            {
+                byte(0xCD);
+                be(v, 2);
+            }
+            else
+            {
+                byte(0xCE);
+                be(v, 4);
+            }
+        }
+
+        void sint(int32_t v)
+        {
+            if (v >= 0)
+            {
+                uint(v);
+            }
+            else if (v >= -32)
+            {
+                byte((uint8_t)(int8_t)v);
+            }
+            else if (v >= -128)
+            {
+                byte(0xD0);
+                byte((uint8_t)(int8_t)v);
+            }
+            else
+            {
+                byte(0xD2);
+                be((uint32_t)v, 4);
+            }
+        }
+
+        void boolean(bool v) { byte(v ? 0xC3 : 0xC2); }
+
+        // fixstr, so at most 31 bytes; `size` is the field the string is in
+        void str(const char *s, size_t size)
+        {
+            size_t len = strnlen(s, size < 31 ? size : 31);
+            byte(0xA0 | len);
+            for (size_t i = 0; i < len; ++i)
+                byte(s[i]);
+        }
+
+        size_t length() const { return overflow ? 0 : pos; }
+
+    private:
+        uint8_t *out;
+        size_t size;
+        size_t pos = 0;
+        bool overflow = false;
+
+        void byte(uint8_t b)
+        {
+            if (pos < size)
+                out[pos++] = b;
+            else
+                overflow = true;
+        }
+
+        void be(uint32_t v, uint8_t bytes)
+        {
+            while (bytes--)
+                byte(v >> (bytes * 8));
+        }
+    };
+
+    bool parseMode(const char *p, size_t len, bool &json, bool &bin)
+    {
+        if (len == 4 && strncmp(p, "json", 4) == 0)
+        {
+            json = true;
+            bin = false;
+        }
+        else if (len == 3 && strncmp(p, "bin", 3) == 0)
+        {
+            json = false;
+            bin = true;
+        }
+        else if (len == 4 && strncmp(p, "both", 4) == 0)
+        {
+            json = bin = true;
+        }
+        else
+        {
+            return false;
+        }
+        return true;
+    }
+}
+
+XYState TelemetryEncoder::stateOf(const char *state)
+{
+    if (strcmp(state, "CL") == 0)
+        return XY_STATE_CL;
+    if (strcmp(state, "OP") == 0)
+        return XY_STATE_OP;
+    return XY_STATE_UNKNOWN;
+}
+
+size_t TelemetryEncoder::encodeData(const XYPacket &packet, uint8_t *out, size_t size)
+{
+    MsgPackWriter w(out, size);
+    w.array(5);
+    w.uint(TELEMETRY_SCHEMA_VERSION);
+    w.uint(packet.centivolts);
+    w.uint(packet.percent);
+    w.uint(packet.hours * 60 + packet.minutes);
+
+    XYState state = stateOf(packet.state);
+    if (state != XY_STATE_UNKNOWN)
+        w.uint(state);
+    else
+        w.str(packet.state, sizeof(packet.state));
+
+    return w.length();
+}
+
+size_t TelemetryEncoder::encodeStatus(const StatusSample &status, uint8_t *out, size_t size)
+{
+    MsgPackWriter w(out, size);
+    w.array(7);
+    w.uint(TELEMETRY_SCHEMA_VERSION);
+    w.boolean(status.online);
+    w.uint(status.ip);
+    w.sint(status.rssi);
+    w.uint(status.uptimeSec);
+    w.uint(status.uartBps);
+    w.uint(status.uartOverruns);
+    return w.length();
+}
+
+bool TelemetryEncoder::parseConfig(const char *spec, uint8_t &mask)
+{
+    if (!spec)
+        return false;
+
+    uint8_t result = mask;
+    bool any = false;
+    const char *p = spec;
+    while (*p)
+    {
+        const char *key = p;
+        while (*p && *p != '=' && *p != ',')
+            p++;
+        size_t keyLen = p - key;
+        if (*p != '=')
+            return false;
+        const char *mode = ++p;
+        while (*p && *p != ',')
+            p++;
+
+        bool json, bin;
+        if (!parseMode(mode, p - mode, json, bin))
+            return false;
+
+        uint8_t jsonBit, binBit;
+        if (keyLen == 4 && strncmp(key, "data", 4) == 0)
+        {
+            jsonBit = ENC_DATA_JSON;
+            binBit = ENC_DATA_BIN;
+        }
+        else if (keyLen == 6 && strncmp(key, "status", 6) == 0)
+        {
+            jsonBit = ENC_STATUS_JSON;
+            binBit = ENC_STATUS_BIN;
+        }
+        else
+        {
+            return false;
+        }
+
+        result = (result & ~(jsonBit | binBit)) | (json ? jsonBit : 0) | (bin ? binBit : 0);
+        any = true;
+
+        if (*p == ',')
+            p++;
+    }
+
+    if (any)
+        mask = result;
+    return any;
+}
@@ -0,0 +1,56 @@
+#ifndef TELEMETRY_ENCODING_H
+#define TELEMETRY_ENCODING_H
+
+#include <Arduino.h>
+#include "XYParser.h"
+
+// Encodings enabled per topic, bit mask
+enum TelemetryEncoding : uint8_t
+{
+    ENC_DATA_JSON = 1 << 0,   // esp/data (and esp/data/batch)
+    ENC_DATA_BIN = 1 << 1,    // esp/data/bin/<client_id>
+    ENC_STATUS_JSON = 1 << 2, // device/status
+    ENC_STATUS_BIN = 1 << 3,  // device/status/bin/<client_id>
+};
+
+const uint8_t DEFAULT_TELEMETRY_ENCODING = ENC_DATA_JSON | ENC_STATUS_JSON;
+
+// Binary payloads are MessagePack arrays, first element is the schema version.
+// device_id is not repeated, it is the last topic level.
+//   data:   [1, centivolts, percent, timer minutes, state]
+//   status: [1, online, ipv4 (uint32, a.b.c.d = a << 24 | ...), rssi, uptime sec,
+//            uart bps, uart overruns]
+// state is an XYState number, or the raw two-char string if unknown.
+const uint8_t TELEMETRY_SCHEMA_VERSION = 1;
+
+enum XYState : uint8_t
+{
+    XY_STATE_UNKNOWN = 0,
+    XY_STATE_CL = 1, // output closed
+    XY_STATE_OP = 2, // output open
+};
+
+struct StatusSample
+{
+    bool online;
+    uint32_t ip;
+    int8_t rssi;
+    uint32_t uptimeSec;
+    uint32_t uartBps;
+    uint32_t uartOverruns;
+};
+
+class TelemetryEncoder
+{
+public:
+    // return payload length, 0 if `size` is too small
+    static size_t encodeData(const XYPacket &packet, uint8_t *out, size_t size);
+    static size_t encodeStatus(const StatusSample &status, uint8_t *out, size_t size);
+
+    static XYState stateOf(const char *state);
+
+    // "data=bin,status=both" (json|bin|both), only the given topics are changed
+    static bool parseConfig(const char *spec, uint8_t &mask);
+};
+
+#endif // TELEMETRY_ENCODING_H
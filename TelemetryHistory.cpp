@@ -0,0 +1,117 @@
+#include "TelemetryHistory.h"
+#include "TelemetryEncoding.h"
+
+void TelemetryHistory::add(const XYPacket &packet, uint32_t time)
+{
+    if (!synced && unixTimeValid(time))
+    {
+        rebase(time - millis() / 1000);
+        synced = true;
+    }
+
+    HistorySample &s = raw[rawHead];
+    s.time = time;
+    s.centivolts = packet.centivolts;
+    s.percent = packet.percent;
+    s.state = TelemetryEncoder::stateOf(packet.state);
+    rawHead = (rawHead + 1) % RAW_SIZE;
+    if (rawCount < RAW_SIZE)
+        rawCount++;
+
+    for (BucketRing &ring : tiers)
+        addToRing(ring, packet, time);
+}
+
+void TelemetryHistory::addToRing(BucketRing &ring, const XYPacket &packet, uint32_t time)
+{
+    uint32_t start = time - time % ring.period;
+    HistoryBucket *b = ring.count ? &ring.buckets[ring.head] : nullptr;
+
+    if (!b || b->start != start)
+    {
+        if (ring.count)
+            ring.head = (ring.head + 1) % ring.capacity;
+        if (ring.count < ring.capacity)
+            ring.count++;
+
+        b = &ring.buckets[ring.head];
+        b->start = start;
+        b->minCentivolts = b->maxCentivolts = packet.centivolts;
+        b->minPercent = b->maxPercent = packet.percent;
+        b->sumCentivolts = 0;
+        b->sumPercent = 0;
+        b->count = 0;
+    }
+
+    if (b->count == 0xFFFF)
+        return;
+
+    b->minCentivolts = min(b->minCentivolts, packet.centivolts);
+    b->maxCentivolts = max(b->maxCentivolts, packet.centivolts);
+    b->minPercent = min<uint8_t>(b->minPercent, packet.percent);
+    b->maxPercent = max<uint8_t>(b->maxPercent, packet.percent);
+    b->sumCentivolts += packet.centivolts;
+    b->sumPercent += packet.percent;
+    b->count++;
+}
+
+void TelemetryHistory::rebase(uint32_t bootTime)
+{
+    for (uint16_t i = 0; i < rawCount; i++)
+    {
+        HistorySample &s = raw[(rawHead + RAW_SIZE - rawCount + i) % RAW_SIZE];
+        if (!unixTimeValid(s.time))
+            s.time += bootTime;
+    }
+
+    for (BucketRing &ring : tiers)
+    {
+        for (uint16_t i = 0; i < ring.count; i++)
+        {
+            HistoryBucket &b = ring.buckets[(ring.head + 1 + ring.capacity - ring.count + i) % ring.capacity];
+            if (!unixTimeValid(b.start))
+            {
+                b.start += bootTime;
+                b.start -= b.start % ring.period;
+            }
+        }
+    }
+}
+
+uint16_t TelemetryHistory::count(HistoryTier tier) const
+{
+    return tier == HISTORY_RAW ? rawCount : tiers[tier - 1].count;
+}
+
+bool TelemetryHistory::sampleAt(uint16_t i, HistorySample &out) const
+{
+    if (i >= rawCount)
+        return false;
+    out = raw[(rawHead + RAW_SIZE - rawCount + i) % RAW_SIZE];
+    return true;
+}
+
+bool TelemetryHistory::bucketAt(HistoryTier tier, uint16_t i, HistoryBucket &out) const
+{
+    if (tier == HISTORY_RAW)
+        return false;
+    const BucketRing &ring = tiers[tier - 1];
+    if (i >= ring.count)
+        return false;
+    // head is the newest bucket
+    out = ring.buckets[(ring.head + 1 + ring.capacity - ring.count + i) % ring.capacity];
+    return true;
+}
+
+bool TelemetryHistory::parseTier(const char *name, HistoryTier &tier)
+{
+    if (strcmp(name, "raw") == 0)
+        tier = HISTORY_RAW;
+    else if (strcmp(name, "1m") == 0)
+        tier = HISTORY_1MIN;
+    else if (strcmp(name, "15m") == 0)
+        tier = HISTORY_15MIN;
+    else
+        return false;
+    return true;
+}
@@ -0,0 +1,84 @@
+#ifndef TELEMETRY_HISTORY_H
+#define TELEMETRY_HISTORY_H
+
+#include <Arduino.h>
+#include "XYParser.h"
+#include "UnixTime.h"
+
+enum HistoryTier : uint8_t
+{
+    HISTORY_RAW = 0,
+    HISTORY_1MIN,
+    HISTORY_15MIN,
+};
+
+struct HistorySample
+{
+    uint32_t time; // unix time (uptime seconds until the first synced sample)
+    uint16_t centivolts;
+    uint8_t percent;
+    uint8_t state; // XYState
+};
+
+struct HistoryBucket
+{
+    uint32_t start; // bucket start time
+    uint16_t minCentivolts;
+    uint16_t maxCentivolts;
+    uint32_t sumCentivolts;
+    uint32_t sumPercent;
+    uint16_t count;
+    uint8_t minPercent;
+    uint8_t maxPercent;
+};
+
+// Fixed-memory time series of XY-L30A samples:
+// raw samples plus 1-min and 15-min min/max/avg tiers, all updated on insert.
+// Samples added before NTP answered carry seconds since boot; the first
+// sample with a valid unix time moves them to unix time.
+class TelemetryHistory
+{
+public:
+    static const uint16_t RAW_SIZE = 120;   // last 120 samples
+    static const uint16_t MIN1_SIZE = 60;   // last hour
+    static const uint16_t MIN15_SIZE = 96;  // last 24 hours
+
+    void add(const XYPacket &packet, uint32_t time);
+
+    uint16_t count(HistoryTier tier) const;
+    // i = 0 is the oldest entry
+    bool sampleAt(uint16_t i, HistorySample &out) const;
+    bool bucketAt(HistoryTier tier, uint16_t i, HistoryBucket &out) const;
+
+    // "raw", "1m", "15m"
+    static bool parseTier(const char *name, HistoryTier &tier);
+
+private:
+    struct BucketRing
+    {
+        HistoryBucket *buckets;
+        uint16_t capacity;
+        uint32_t period; // seconds
+        uint16_t head;   // index of the current (newest) bucket
+        uint16_t count;
+    };
+
+    HistorySample raw[RAW_SIZE];
+    uint16_t rawHead = 0; // next write position
+    uint16_t rawCount = 0;
+
+    HistoryBucket min1[MIN1_SIZE];
+    HistoryBucket min15[MIN15_SIZE];
+    BucketRing tiers[2] = {
+        {min1, MIN1_SIZE, 60, 0, 0},
+        {min15, MIN15_SIZE, 900, 0, 0},
+    };
+
+    bool synced = false;
+
+    static void addToRing(BucketRing &ring, const XYPacket &packet, uint32_t time);
+    // unix time of boot added to the entries stamped with uptime
+    void rebase(uint32_t bootTime);
+};
+
+#endif // TELEMETRY_HISTORY_H
@@ -0,0 +1,224 @@
+#include "TelemetryOutbox.h"
+#include <LittleFS.h>
+
+namespace
+{
+    const char OUTBOX_DIR[] PROGMEM = "/outbox";
+}
+
+void TelemetryOutbox::segmentPath(uint32_t seq, char *out, size_t size)
+{
+    snprintf_P(out, size, PSTR("%S/%08lu.log"), OUTBOX_DIR, (unsigned long)seq);
+}
+
+bool TelemetryOutbox::begin()
+{
+    char dirPath[sizeof(OUTBOX_DIR)];
+    strcpy_P(dirPath, OUTBOX_DIR);
+    if (!LittleFS.exists(dirPath) && !LittleFS.mkdir(dirPath))
+        return false;
+
+    // find the segment range left from before the reboot
+    bool any = false;
+    Dir dir = LittleFS.openDir(dirPath);
+    while (dir.next())
+    {
+        uint32_t seq = strtoul(dir.fileName().c_str(), nullptr, 10);
+        if (!any || seq < firstSeq)
+            firstSeq = seq;
+        if (!any || seq > lastSeq)
+        {
+            lastSeq = seq;
+            lastSize = dir.fileSize();
+        }
+        any = true;
+    }
+    readOffset = 0;
+    ready = true;
+    return true;
+}
+
+bool TelemetryOutbox::append(const char *topic, const char *payload)
+{
+    return appendRecord(topic, payload, nullptr, 0);
+}
+
+bool TelemetryOutbox::appendBinary(const char *topic, const uint8_t *payload, size_t len)
+{
+    return len > 0 && appendRecord(topic, nullptr, payload, len);
+}
+
+// one of payload (text) or bytes (hex-encoded) is written
+bool TelemetryOutbox::appendRecord(const char *topic, const char *payload, const uint8_t *bytes, size_t bytesLen)
+{
+    if (!ready)
+        return false;
+
+    size_t payloadLen = payload ? strlen(payload) : 1 + bytesLen * 2;
+    size_t recordLen = strlen(topic) + 1 + payloadLen + 1;
+    if (recordLen > RECORD_SIZE)
+        return false;
+
+    if (lastSize > 0 && lastSize + recordLen > SEGMENT_SIZE)
+    {
+        lastSeq++;
+        lastSize = 0;
+        if (lastSeq - firstSeq + 1 > MAX_SEGMENTS)
+            dropOldest();
+    }
+
+    char path[24];
+    segmentPath(lastSeq, path, sizeof(path));
+    File f = LittleFS.open(path, "a");
+    if (!f)
+        return false;
+
+    f.print(topic);
+    f.write('\t');
+    if (payload)
+    {
+        f.print(payload);
+    }
+    else
+    {
+        static const char digits[] = "0123456789abcdef";
+        char hex[2];
+        f.write(BINARY_MARK);
+        for (size_t i = 0; i < bytesLen; i++)
+        {
+            hex[0] = digits[bytes[i] >> 4];
+            hex[1] = digits[bytes[i] & 0x0f];
+            f.write((const uint8_t *)hex, 2);
+        }
+    }
+    f.write('\n');
+    f.close();
+
+    lastSize += recordLen;
+    _stored++;
+    return true;
+}
+
+// `out` may overlap `hex` from one char before, returns the number of bytes
+// or 0 if `hex` is not valid
+size_t TelemetryOutbox::decodeHex(const char *hex, size_t len, uint8_t *out)
+{
+    if (len == 0 || len % 2 != 0)
+        return 0;
+
+    for (size_t i = 0; i < len; i += 2)
+    {
+        uint8_t value = 0;
+        for (size_t j = i; j < i + 2; j++)
+        {
+            char c = hex[j];
+            if (c >= '0' && c <= '9')
+                value = (value << 4) | (c - '0');
+            else if (c >= 'a' && c <= 'f')
+                value = (value << 4) | (c - 'a' + 10);
+            else
+                return 0;
+        }
+        out[i / 2] = value;
+    }
+    return len / 2;
+}
+
+void TelemetryOutbox::dropOldest()
+{
+    char path[24];
+    segmentPath(firstSeq, path, sizeof(path));
+
+    // count the records that were never sent
+    File f = LittleFS.open(path, "r");
+    if (f)
+    {
+        f.seek(readOffset);
+        while (f.available())
+        {
+            if (f.read() == '\n')
+                _dropped++;
+        }
+        f.close();
+    }
+
+    LittleFS.remove(path);
+    firstSeq++;
+    readOffset = 0;
+}
+
+uint16_t TelemetryOutbox::drain(PublishFn publish, uint16_t maxRecords)
+{
+    if (!ready)
+        return 0;
+
+    static char record[RECORD_SIZE + 1];
+    char path[24];
+    uint16_t sent = 0;
+
+    while (sent < maxRecords && !empty())
+    {
+        segmentPath(firstSeq, path, sizeof(path));
+        File f = LittleFS.open(path, "r");
+        size_t len = 0;
+        bool complete = false;
+        if (f && f.seek(readOffset))
+        {
+            len = f.readBytesUntil('\n', record, RECORD_SIZE);
+            complete = f.position() > readOffset + len; // '\n' was consumed
+        }
+        if (f)
+            f.close();
+
+        if (!complete)
+        {
+            // end of segment
+            LittleFS.remove(path);
+            if (firstSeq == lastSeq)
+            {
+                lastSize = 0;
+                readOffset = 0;
+                break;
+            }
+            firstSeq++;
+            readOffset = 0;
+            continue;
+        }
+
+        record[len] = '\0';
+        char *tab = strchr(record, '\t');
+        if (tab)
+        {
+            *tab = '\0';
+            char *payload = tab + 1;
+            size_t payloadLen = record + len - payload;
+            bool binary = *payload == BINARY_MARK;
+            if (binary)
+                payloadLen = decodeHex(payload + 1, payloadLen - 1, (uint8_t *)payload);
+
+            if (binary && payloadLen == 0)
+            {
+                _dropped++; // corrupt record
+            }
+            else
+            {
+                if (!publish(record, (const uint8_t *)payload, payloadLen))
+                    break;
+                sent++;
+                _replayed++;
+            }
+        }
+        readOffset += len + 1;
+    }
+
+    // fully drained: the active segment goes too, or a reboot would read it
+    // again from the start (begin() cannot know how far it was sent)
+    if (empty() && lastSize > 0)
+    {
+        segmentPath(lastSeq, path, sizeof(path));
+        LittleFS.remove(path);
+        lastSize = 0;
+        readOffset = 0;
+    }
+    return sent;
+}
@@ -0,0 +1,59 @@
+#ifndef TELEMETRY_OUTBOX_H
+#define TELEMETRY_OUTBOX_H
+
+#include <Arduino.h>
+#include <functional>
+
+// Store-and-forward queue on LittleFS for telemetry produced while MQTT is
+// down. Records ("<topic>\t<payload>\n") are appended to segment files
+// /outbox/<seq>.log; binary payloads are stored as "=<hex>" and decoded
+// again before publish. the oldest segment is dropped (and counted) once
+// MAX_SEGMENTS are in use. drain() replays records oldest first.
+// Delivery is at-least-once: a reboot while draining repeats the current
+// segment from its start; drained segments (the active one included) are
+// removed, so they are not sent again.
+class TelemetryOutbox
+{
+public:
+    static const size_t SEGMENT_SIZE = 4096;
+    static const uint8_t MAX_SEGMENTS = 8; // 32 KB on flash at most
+    static const size_t RECORD_SIZE = 320; // longest record incl. topic
+
+    typedef std::function<bool(const char *topic, const uint8_t *payload, size_t len)> PublishFn;
+
+    // call after LittleFS.begin(), picks up segments left before a reboot
+    bool begin();
+
+    bool append(const char *topic, const char *payload);
+    bool appendBinary(const char *topic, const uint8_t *payload, size_t len);
+
+    // publishes up to maxRecords oldest records, stops at the first failed
+    // publish, returns the number published
+    uint16_t drain(PublishFn publish, uint16_t maxRecords);
+
+    bool empty() const { return firstSeq == lastSeq && readOffset >= lastSize; }
+    uint32_t stored() const { return _stored; }   // appended since boot
+    uint32_t replayed() const { return _replayed; } // drained since boot
+    uint32_t dropped() const { return _dropped; }   // evicted since boot
+    uint8_t segments() const { return ready && !empty() ? lastSeq - firstSeq + 1 : 0; }
+
+private:
+    bool ready = false;
+    uint32_t firstSeq = 0; // oldest segment, read from readOffset
+    uint32_t lastSeq = 0;  // segment being appended to
+    size_t lastSize = 0;
+    size_t readOffset = 0;
+
+    uint32_t _stored = 0;
+    uint32_t _replayed = 0;
+    uint32_t _dropped = 0;
+
+    static const char BINARY_MARK = '=';
+
+    static void segmentPath(uint32_t seq, char *out, size_t size);
+    static size_t decodeHex(const char *hex, size_t len, uint8_t *out);
+    bool appendRecord(const char *topic, const char *payload, const uint8_t *bytes, size_t bytesLen);
+    void dropOldest();
+};
+
+#endif // TELEMETRY_OUTBOX_H
@@ -0,0 +1,37 @@
+#ifndef TLS_RESUMPTION_H
+#define TLS_RESUMPTION_H
+
+#include <Arduino.h>
+
+// Tells whether a TLS connect resumed the cached session. BearSSL keeps the
+// session parameters (id, master secret) on resumption and replaces them
+// after a full handshake, so the bytes before and after connect() are
+// compared. Session is BearSSL::Session, default constructed = no session.
+template <typename Session>
+class TlsResumption
+{
+public:
+    // before connect(): remember the session that will be offered
+    void offer(const Session &session)
+    {
+        cached = session;
+        offered = !same(session, Session());
+    }
+
+    // after a successful connect()
+    bool resumed(const Session &session) const
+    {
+        return offered && same(cached, session);
+    }
+
+private:
+    Session cached;
+    bool offered = false;
+
+    static bool same(const Session &a, const Session &b)
+    {
+        return memcmp(&a, &b, sizeof(Session)) == 0;
+    }
+};
+
+#endif // TLS_RESUMPTION_H
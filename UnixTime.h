@@ -0,0 +1,12 @@
+#ifndef UNIX_TIME_H
+#define UNIX_TIME_H
+
+#include <time.h>
+
+// time(nullptr) counts seconds from boot (a 1970 date) until the first
+// NTP answer; anything later than this is a synced unix time
+const time_t UNIX_TIME_VALID_AFTER = 1600000000;
+
+inline bool unixTimeValid(time_t t) { return t > UNIX_TIME_VALID_AFTER; }
+
+#endif // UNIX_TIME_H
@@ -0,0 +1,212 @@
+// Generated by tools/build_web_assets.py from web/, do not edit.
+#ifndef WEB_ASSETS_H
+#define WEB_ASSETS_H
+
+#include <Arduino.h>
+
+struct WebAsset
+{
+    const char *path;
+    const char *contentType;
+    const uint8_t *gzData; // PROGMEM
+    size_t gzLength;
+    const char *etag; // quoted, strong
+    bool immutable;   // URL changes with the content
+};
+
+// web/app.js: 5215 bytes, 1877 gzipped
+const uint8_t APP_JS_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xa5, 0x58, 0xeb, 0x72, 0xdb, 0xc6,
+    0x15, 0xfe, 0xaf, 0xa7, 0x38, 0x41, 0xaa, 0x10, 0x68, 0x10, 0xe8, 0xd2, 0x74, 0xa6, 0x35, 0x75,
+    0x99, 0xc4, 0x76, 0x26, 0xee, 0xd8, 0x91, 0x63, 0xcb, 0xf6, 0x0f, 0x55, 0x13, 0xaf, 0x80, 0x25,
+    0xb9, 0x09, 0x6e, 0x59, 0x2c, 0x48, 0x71, 0x1c, 0xfe, 0xed, 0x03, 0xf4, 0x11, 0xfb, 0x24, 0xfd,
+    0xce, 0x2e, 0x40, 0x00, 0x24, 0x25, 0x4b, 0x93, 0x19, 0x8f, 0x06, 0xdc, 0x73, 0xbf, 0x7d, 0x7b,
+    0xd6, 0x93, 0x3a, 0x8f, 0x8d, 0x2a, 0x72, 0xaa, 0x66, 0xc5, 0xe2, 0xd5, 0xcf, 0x97, 0x97, 0x6f,
+    0x8d, 0x30, 0x75, 0xe5, 0x27, 0xc2, 0x88, 0x80, 0x3e, 0xed, 0x11, 0xc5, 0x45, 0x5e, 0x19, 0x92,
+    0x29, 0x9d, 0x52, 0x52, 0xc4, 0x75, 0x26, 0x73, 0x13, 0x4d, 0xa5, 0x79, 0x9e, 0x4a, 0xfe, 0xfc,
+    0x7e, 0xf9, 0x22, 0xf1, 0xbd, 0xec, 0x77, 0x63, 0x9c, 0xa0, 0x17, 0x8c, 0x21, 0xa3, 0x26, 0x64,
+    0x35, 0x44, 0x4c, 0xa0, 0xd3, 0xd3, 0x53, 0xf2, 0xa0, 0x26, 0x97, 0xb1, 0x91, 0x89, 0xe7, 0xd4,
+    0x12, 0x54, 0x46, 0x0a, 0x67, 0xfa, 0xc7, 0xcb, 0x57, 0x2f, 0xa1, 0x7c, 0xc4, 0xd6, 0x9f, 0xd0,
+    0x49, 0x55, 0x0a, 0x78, 0x63, 0x96, 0xa9, 0x3c, 0x85, 0x50, 0x5a, 0xe8, 0x27, 0x53, 0x2d, 0x65,
+    0xee, 0x9d, 0x5d, 0xe4, 0xa9, 0xca, 0xe5, 0xc9, 0x01, 0x33, 0x9c, 0x8d, 0xd8, 0xcc, 0x0a, 0x3a,
+    0x2a, 0xd9, 0x59, 0xd3, 0xd2, 0xe8, 0xe5, 0xa3, 0xd5, 0x6b, 0xf8, 0x74, 0x76, 0x31, 0x99, 0xf4,
+    0xb4, 0x87, 0x64, 0x55, 0xd1, 0x88, 0xbe, 0xa6, 0x4e, 0x33, 0x7d, 0x6d, 0x15, 0x13, 0x8e, 0x55,
+    0x6e, 0x69, 0xaf, 0x84, 0x99, 0x45, 0xba, 0xa8, 0xf3, 0xc4, 0x39, 0x90, 0xcb, 0x5b, 0xf3, 0x4b,
+    0x56, 0xd1, 0x01, 0x1d, 0x1d, 0x1e, 0x1e, 0x06, 0xe0, 0x18, 0x51, 0xd5, 0x77, 0xf5, 0xcf, 0xbb,
+    0xe6, 0xb4, 0xed, 0xad, 0xf6, 0xf6, 0x26, 0x6d, 0xe9, 0xea, 0x12, 0xc6, 0x65, 0xaf, 0x78, 0x2e,
+    0x05, 0x13, 0x69, 0xe2, 0x99, 0x3f, 0x3a, 0xa8, 0xec, 0xe1, 0x28, 0xa4, 0x4f, 0x14, 0x43, 0x21,
+    0x8a, 0xa6, 0x44, 0x5a, 0x3d, 0xa1, 0x91, 0xca, 0xe3, 0xb4, 0x4e, 0xe4, 0x88, 0x56, 0x81, 0x75,
+    0x2b, 0x32, 0x33, 0x99, 0xfb, 0x9a, 0x4e, 0xcf, 0x48, 0x47, 0xbf, 0x56, 0x45, 0xee, 0x07, 0x7d,
+    0xc2, 0xb0, 0x43, 0x50, 0x67, 0xf8, 0x70, 0x70, 0x40, 0xa9, 0x9a, 0x4b, 0xaa, 0x44, 0x56, 0xa6,
+    0xb2, 0x0a, 0xb9, 0x5b, 0x26, 0x6a, 0x4a, 0x32, 0x9e, 0x15, 0xb2, 0x22, 0x91, 0x27, 0xc4, 0x22,
+    0xc4, 0x3e, 0x48, 0x2a, 0xeb, 0x6a, 0x26, 0x13, 0xba, 0x59, 0x12, 0x14, 0x52, 0x22, 0xe7, 0x2a,
+    0x96, 0xe4, 0x1f, 0xc8, 0x39, 0x7c, 0x62, 0x85, 0xd0, 0x56, 0x16, 0x29, 0x82, 0x9d, 0x52, 0xe3,
+    0x35, 0xa9, 0x8a, 0x8a, 0x3c, 0x75, 0x02, 0x13, 0x91, 0xa6, 0x37, 0x22, 0xfe, 0xad, 0x8b, 0xbc,
+    0x69, 0xaa, 0xe7, 0x56, 0x41, 0x13, 0x36, 0x77, 0xc3, 0x17, 0x0b, 0x95, 0x27, 0xc5, 0x22, 0xb2,
+    0x84, 0xb7, 0x45, 0xad, 0x63, 0xd9, 0xb6, 0xc5, 0x76, 0xb2, 0xc6, 0xf6, 0xbc, 0x92, 0xe6, 0x45,
+    0x6e, 0xa4, 0x9e, 0x8b, 0xd4, 0xdf, 0xe4, 0x09, 0xe9, 0xef, 0x5c, 0x4e, 0xc7, 0x88, 0x56, 0xa8,
+    0x75, 0xee, 0xaa, 0xd0, 0x8d, 0x87, 0xf5, 0x00, 0xb5, 0xcc, 0xe5, 0x82, 0x7a, 0x56, 0x91, 0x7e,
+    0x47, 0x1a, 0x59, 0x69, 0xf7, 0x1d, 0x89, 0x24, 0xb1, 0x3c, 0x2f, 0x55, 0x65, 0x24, 0xfa, 0xc0,
+    0x1f, 0xf1, 0x9c, 0xa0, 0x42, 0x92, 0x73, 0xbf, 0x31, 0x89, 0xff, 0x7a, 0x7b, 0xf1, 0x53, 0x54,
+    0x0a, 0x5d, 0x49, 0x5f, 0x46, 0x76, 0x2c, 0x83, 0xfb, 0x75, 0x31, 0x4f, 0xab, 0xcb, 0xc5, 0xec,
+    0x7c, 0x4c, 0xe0, 0xde, 0xb6, 0x32, 0x17, 0xd4, 0x5d, 0x93, 0x3d, 0xe2, 0xea, 0x8e, 0x82, 0xc8,
+    0xa0, 0xb1, 0x9f, 0x16, 0xc8, 0x4f, 0x8e, 0x71, 0xa6, 0x8f, 0x7f, 0xf9, 0x94, 0x44, 0xf3, 0x22,
+    0x35, 0x62, 0x2a, 0x57, 0xf4, 0x9e, 0x88, 0x7f, 0x97, 0x12, 0xf1, 0xe6, 0x66, 0xb5, 0xef, 0x7e,
+    0x1a, 0x95, 0x81, 0x66, 0x3f, 0x6d, 0xf1, 0x57, 0x1f, 0x6d, 0xca, 0xee, 0x77, 0xdd, 0x75, 0xcf,
+    0x2e, 0xe7, 0xcb, 0x9d, 0xce, 0xf3, 0x2f, 0x81, 0x79, 0xfb, 0xe3, 0x0f, 0xfa, 0xb4, 0x72, 0x91,
+    0x70, 0xf9, 0xcb, 0x28, 0x59, 0x04, 0x77, 0xc7, 0x94, 0x2c, 0x10, 0x11, 0xea, 0x5c, 0xc3, 0x0a,
+    0x31, 0x6f, 0x5f, 0xb2, 0x2e, 0xef, 0x91, 0xac, 0xcb, 0x81, 0x64, 0x5d, 0xf6, 0x25, 0x39, 0x62,
+    0x7d, 0x8f, 0xb0, 0xa5, 0x0f, 0xe4, 0xed, 0x49, 0x9b, 0x16, 0xdb, 0x4d, 0xeb, 0xce, 0xae, 0x64,
+    0x9e, 0x3c, 0x2d, 0xb2, 0x0c, 0x13, 0xe4, 0xc7, 0x59, 0x82, 0x8c, 0xcc, 0xbb, 0xf6, 0x6e, 0xbf,
+    0x39, 0x93, 0x51, 0xa9, 0x6d, 0x3a, 0x9f, 0xc9, 0x89, 0xa8, 0x53, 0xd3, 0xb6, 0x33, 0x08, 0x95,
+    0x29, 0xca, 0xd7, 0xba, 0x28, 0xc5, 0x54, 0xb0, 0x4a, 0x47, 0x81, 0x15, 0xd7, 0xc0, 0x1d, 0x3c,
+    0xc0, 0xd2, 0x79, 0xec, 0x4c, 0x9d, 0x32, 0xa8, 0xc9, 0x3c, 0x2e, 0x12, 0xf9, 0xee, 0xcd, 0x0b,
+    0xd8, 0x2f, 0x8b, 0x1c, 0xba, 0xd9, 0x03, 0x0b, 0x05, 0x0d, 0x42, 0x60, 0xb2, 0x19, 0x23, 0x64,
+    0xd5, 0x43, 0x09, 0x47, 0xe2, 0xaa, 0x74, 0xa5, 0x53, 0x13, 0x07, 0x8b, 0x52, 0xeb, 0x42, 0xb7,
+    0x2e, 0x13, 0x66, 0x59, 0x17, 0x0b, 0x37, 0x29, 0x4c, 0xe8, 0xf3, 0x38, 0xe7, 0x57, 0xbd, 0x41,
+    0xa3, 0x85, 0x50, 0xe6, 0x8d, 0xac, 0x38, 0x36, 0xcb, 0xa8, 0x12, 0x17, 0xc8, 0x5d, 0x46, 0x5d,
+    0xbf, 0x64, 0xd5, 0xb4, 0x7f, 0x61, 0x01, 0xf8, 0xd0, 0x83, 0x4d, 0x39, 0xd0, 0x01, 0x6a, 0x3e,
+    0x6a, 0x6c, 0x81, 0x71, 0x00, 0xc6, 0x1f, 0x4f, 0x6e, 0xce, 0xd0, 0xb4, 0x6c, 0x09, 0x51, 0xaf,
+    0x4e, 0x0e, 0x6e, 0xce, 0xe8, 0x7f, 0xff, 0xf9, 0x2f, 0x9d, 0x20, 0xcf, 0x2d, 0x01, 0x91, 0x23,
+    0x31, 0x95, 0x04, 0x95, 0x4f, 0x3f, 0x7e, 0x66, 0x86, 0x32, 0x59, 0x55, 0x98, 0x14, 0x60, 0x00,
+    0x17, 0xab, 0x44, 0xbe, 0x7d, 0x58, 0x6d, 0xec, 0xaf, 0x1b, 0xa8, 0x35, 0xe9, 0xae, 0x4b, 0xf8,
+    0x9b, 0x78, 0xf4, 0xd5, 0x57, 0x64, 0x96, 0xa5, 0x2c, 0x26, 0x34, 0xb0, 0xeb, 0x58, 0x2a, 0xa3,
+    0x81, 0x94, 0x5e, 0x97, 0x57, 0x17, 0x79, 0x9c, 0x4a, 0x5c, 0x23, 0xa7, 0x43, 0x89, 0x86, 0x03,
+    0x19, 0x83, 0x03, 0xa9, 0x00, 0x30, 0x79, 0xc9, 0xc2, 0x0b, 0xc9, 0xf3, 0x82, 0x1d, 0xa4, 0xba,
+    0xbc, 0x93, 0xf4, 0xef, 0x7c, 0x93, 0x04, 0x2f, 0x32, 0xee, 0xad, 0x81, 0x13, 0x57, 0xc9, 0x22,
+    0x04, 0xd4, 0x86, 0x64, 0x5b, 0xfc, 0x1a, 0xee, 0x58, 0xb7, 0xa2, 0xaa, 0x4c, 0x95, 0xf1, 0xbd,
+    0xd0, 0xeb, 0x04, 0x6c, 0xec, 0x0f, 0x1e, 0xd7, 0x76, 0x58, 0x9d, 0xdc, 0xc3, 0x87, 0xb5, 0x1d,
+    0x55, 0x27, 0xf7, 0xd8, 0x51, 0x5d, 0x0f, 0x6a, 0x03, 0xfa, 0xbd, 0xb2, 0x7d, 0xb6, 0x3e, 0x5c,
+    0xc4, 0x01, 0x35, 0x6a, 0xee, 0xdd, 0xca, 0xf7, 0x9e, 0x5d, 0x7c, 0xf8, 0xc9, 0x0b, 0xba, 0x0a,
+    0xf6, 0xa7, 0xde, 0xb5, 0x40, 0x30, 0xa6, 0xbe, 0xd9, 0x66, 0x26, 0x58, 0x5f, 0x37, 0x04, 0xb1,
+    0xe0, 0x49, 0xc6, 0x00, 0x6d, 0x0e, 0x81, 0x9d, 0xa9, 0x87, 0x8d, 0x81, 0x65, 0x8d, 0xe2, 0x54,
+    0x54, 0x15, 0xc3, 0x31, 0x63, 0x33, 0x5a, 0x44, 0xe4, 0x53, 0xa9, 0xbf, 0x61, 0xf0, 0xf7, 0x06,
+    0x7c, 0xc3, 0xeb, 0xc0, 0xf3, 0x18, 0x35, 0xb4, 0x7e, 0xfc, 0x18, 0xf4, 0x87, 0xde, 0xa1, 0x42,
+    0xa3, 0x66, 0xd5, 0x82, 0x15, 0x56, 0x02, 0x8b, 0x50, 0x6e, 0x0b, 0xf8, 0xbd, 0x96, 0x35, 0xc0,
+    0x87, 0x97, 0x81, 0x06, 0xb1, 0x42, 0xbb, 0x31, 0xd0, 0x81, 0xb6, 0x08, 0x41, 0x35, 0x96, 0x9b,
+    0xd4, 0xd2, 0xdf, 0x7d, 0xf7, 0xe6, 0x92, 0xb8, 0x6d, 0x97, 0xbc, 0x43, 0x80, 0x1b, 0xfb, 0x89,
+    0x91, 0xdd, 0xea, 0xd0, 0x83, 0x15, 0x20, 0x8a, 0x4d, 0xdb, 0x06, 0x30, 0x3a, 0x95, 0xe7, 0xca,
+    0xa1, 0xa2, 0x4a, 0x1e, 0xbc, 0x40, 0xed, 0x82, 0xc7, 0xdd, 0x58, 0xd5, 0x9b, 0xfc, 0x0d, 0x8c,
+    0x7c, 0x00, 0x4a, 0xb6, 0x38, 0xd9, 0x53, 0xd2, 0x2c, 0x4d, 0xb6, 0xfd, 0x38, 0xc1, 0x43, 0x7c,
+    0x58, 0x47, 0xc8, 0x4a, 0x71, 0x33, 0x64, 0x0a, 0x37, 0x29, 0xdc, 0x2c, 0xd2, 0xb9, 0x5b, 0x3c,
+    0xa4, 0xb9, 0x44, 0xa3, 0x17, 0xb5, 0x69, 0x4f, 0x43, 0xde, 0x63, 0x83, 0xc0, 0xb9, 0x8e, 0xfd,
+    0x0a, 0x4c, 0xc3, 0xbc, 0x6d, 0xb9, 0xb2, 0xd1, 0xa0, 0xeb, 0xab, 0x0d, 0x75, 0x6c, 0x16, 0x06,
+    0x8a, 0x67, 0x42, 0x9b, 0x27, 0xa4, 0xc5, 0x82, 0x10, 0x21, 0x96, 0x44, 0x2d, 0xe9, 0xca, 0x84,
+    0xf1, 0xfb, 0x70, 0x3f, 0xb4, 0xab, 0xc2, 0x35, 0xc3, 0x86, 0xd4, 0x03, 0x6a, 0xa6, 0xf2, 0xa7,
+    0xf3, 0x30, 0x13, 0xb7, 0xf8, 0x2b, 0xe6, 0x53, 0xfe, 0x56, 0xf9, 0x3e, 0x1f, 0xec, 0xf3, 0xef,
+    0xfd, 0xeb, 0xae, 0xb2, 0x69, 0x21, 0x92, 0x1f, 0xd1, 0xc3, 0x85, 0x5e, 0xfa, 0xfd, 0x27, 0x8c,
+    0xd5, 0x79, 0xf7, 0x23, 0x66, 0x34, 0x73, 0x32, 0x97, 0xaa, 0x1b, 0xfd, 0x71, 0x6f, 0x8d, 0x6e,
+    0xc8, 0xe7, 0xac, 0xc6, 0x76, 0x04, 0x7f, 0xfc, 0xe9, 0xa5, 0x7a, 0xb3, 0x1f, 0x1a, 0x0c, 0xbf,
+    0xcf, 0x4f, 0x9b, 0xbf, 0xd1, 0x3a, 0xf3, 0x71, 0xb4, 0x50, 0x89, 0x99, 0x31, 0xc4, 0x62, 0x7e,
+    0x15, 0xd8, 0x3e, 0xf0, 0xef, 0xf1, 0x50, 0xa1, 0xb9, 0xb5, 0x0c, 0xd0, 0x65, 0xe7, 0xf6, 0x16,
+    0xd3, 0x7f, 0x9c, 0xf4, 0x94, 0x98, 0xdb, 0x88, 0x11, 0x5a, 0xbf, 0xc1, 0x3a, 0xed, 0x1f, 0x86,
+    0x84, 0x7f, 0x8d, 0x62, 0xfe, 0x98, 0x49, 0x35, 0x9d, 0x99, 0x60, 0xa8, 0xd3, 0x96, 0xa7, 0xb9,
+    0x67, 0x9a, 0xfd, 0x9f, 0x17, 0xb1, 0xab, 0xeb, 0x3e, 0xd2, 0x32, 0x53, 0x94, 0xca, 0x7c, 0x0a,
+    0x0f, 0x4f, 0xe8, 0x38, 0xe8, 0xad, 0xcf, 0x3d, 0x4d, 0x68, 0x85, 0x46, 0x91, 0x2b, 0x92, 0xbd,
+    0x01, 0xc5, 0xc2, 0x1b, 0xb2, 0xa5, 0x05, 0xb8, 0xec, 0x93, 0x0b, 0xb5, 0xf7, 0xa3, 0x28, 0xb2,
+    0xca, 0x33, 0x51, 0x36, 0xe9, 0xbd, 0x3a, 0xba, 0x0e, 0x36, 0x7c, 0x9c, 0xa9, 0xb5, 0x88, 0xb8,
+    0xdd, 0x21, 0x02, 0xc3, 0xe7, 0x56, 0x90, 0xd0, 0x90, 0x57, 0xc7, 0x5b, 0xf2, 0x9c, 0x35, 0xc5,
+    0x9c, 0x8a, 0xfe, 0x4a, 0x7e, 0x9b, 0xea, 0x6f, 0xe8, 0x28, 0xc0, 0x1b, 0x6f, 0x10, 0x1c, 0x9f,
+    0x0d, 0x65, 0x97, 0x90, 0x9d, 0xb3, 0x6c, 0x9b, 0x3f, 0xe6, 0xf9, 0x16, 0x7f, 0xfc, 0x39, 0xfe,
+    0xa4, 0x45, 0xe0, 0x54, 0xae, 0x69, 0xc7, 0xff, 0x60, 0xa5, 0x6b, 0x67, 0xe1, 0x3a, 0x73, 0x85,
+    0x5b, 0x7a, 0xf9, 0x31, 0x08, 0xd5, 0x3e, 0x9e, 0x88, 0xfc, 0xde, 0x4a, 0x19, 0x36, 0x7a, 0x1d,
+    0xe4, 0x8a, 0x89, 0xcb, 0xa7, 0xf8, 0x4d, 0xbe, 0xe5, 0xc7, 0x24, 0x17, 0x9e, 0xb9, 0xc6, 0x03,
+    0x86, 0x1b, 0x39, 0x55, 0xf9, 0x6b, 0x18, 0xf3, 0x83, 0x8e, 0x60, 0x03, 0x9a, 0x14, 0xfa, 0xb9,
+    0x40, 0xcb, 0xfb, 0xe8, 0x6e, 0x15, 0xb8, 0xe0, 0xcf, 0xad, 0x0c, 0x5b, 0xbe, 0x2c, 0xfc, 0x5b,
+    0x5f, 0x05, 0x21, 0x2d, 0x7d, 0x7d, 0x05, 0xbd, 0x48, 0x19, 0x72, 0xc7, 0xd4, 0xac, 0x98, 0xef,
+    0xa2, 0x06, 0xe3, 0x1d, 0x8e, 0x75, 0x46, 0x57, 0xfd, 0x6e, 0xf9, 0x02, 0x05, 0xc1, 0xc8, 0xda,
+    0x10, 0xfd, 0x23, 0x2c, 0x1a, 0x5f, 0x0a, 0x21, 0xf8, 0x0e, 0xb4, 0x07, 0xc7, 0xbd, 0x83, 0x16,
+    0x6f, 0x2c, 0xc1, 0x95, 0xf1, 0x08, 0x7e, 0xfc, 0x8d, 0x59, 0xe4, 0x3f, 0xf1, 0x5a, 0x3b, 0xf4,
+    0x06, 0xcd, 0x3d, 0x51, 0x69, 0xda, 0x66, 0xc3, 0xfb, 0x92, 0xc9, 0x9b, 0xd4, 0x4b, 0x1e, 0x0a,
+    0xce, 0xba, 0x7d, 0xbc, 0x03, 0xf3, 0x8a, 0x1f, 0xd4, 0xad, 0x4c, 0xfc, 0x63, 0x7e, 0xc6, 0x7b,
+    0xf4, 0x1e, 0x7b, 0xcf, 0x31, 0xe3, 0x61, 0xb0, 0x5b, 0x10, 0xcd, 0x79, 0xaf, 0x60, 0xbf, 0xd0,
+    0xc1, 0x00, 0x1a, 0xfb, 0xaf, 0xd9, 0x89, 0xd2, 0x19, 0xd0, 0x55, 0x62, 0x86, 0x27, 0xca, 0xb7,
+    0x8b, 0x7d, 0xb7, 0xf6, 0x37, 0x8f, 0xda, 0x86, 0xcd, 0xf7, 0xbe, 0x03, 0x34, 0x2e, 0x8b, 0x9a,
+    0xaa, 0xba, 0xf9, 0x58, 0x08, 0xdc, 0xc7, 0xa6, 0xe0, 0xab, 0x47, 0x1a, 0x5a, 0x40, 0x45, 0x1f,
+    0x9c, 0xce, 0xbb, 0x4d, 0xa3, 0xbf, 0x67, 0x8c, 0x2c, 0xf7, 0x2f, 0xcc, 0xcd, 0x0f, 0x2f, 0x6b,
+    0xb2, 0xfd, 0x2f, 0x86, 0xc6, 0xe2, 0xf6, 0x43, 0xed, 0xd9, 0xc5, 0xab, 0xe6, 0xfe, 0x7f, 0x09,
+    0xb4, 0x95, 0x09, 0x24, 0xfd, 0x75, 0x17, 0x6e, 0xbc, 0xca, 0x39, 0xd8, 0x5d, 0x8b, 0x0d, 0x8e,
+    0x07, 0x50, 0x8d, 0x64, 0xb8, 0xad, 0xb0, 0xf7, 0x08, 0x32, 0xcf, 0x3e, 0xf4, 0x5e, 0x3b, 0xae,
+    0xff, 0x81, 0xcc, 0xf7, 0xc1, 0x63, 0xb7, 0x2e, 0x8e, 0xb7, 0x62, 0xe5, 0xa5, 0x17, 0x45, 0x01,
+    0xd5, 0x3e, 0xa8, 0xd6, 0x8f, 0xf8, 0xbe, 0xc5, 0x77, 0xaf, 0x1f, 0x6b, 0xb1, 0x5b, 0x34, 0x77,
+    0x58, 0xc4, 0x2e, 0xfd, 0x39, 0x8b, 0x7c, 0xe9, 0xea, 0xc7, 0x1a, 0x1d, 0xac, 0xa8, 0xdb, 0x76,
+    0xb7, 0x0c, 0xae, 0x15, 0x61, 0xbc, 0xb3, 0x2a, 0x2a, 0xeb, 0x9b, 0x54, 0x55, 0xb3, 0x08, 0xa6,
+    0xea, 0x9b, 0x4c, 0xf1, 0x1a, 0xd7, 0xba, 0xb4, 0xe5, 0x09, 0x5f, 0x17, 0xbc, 0x04, 0xe3, 0x06,
+    0x8c, 0x9a, 0x25, 0xee, 0x2e, 0xb3, 0xcc, 0xda, 0xd9, 0x1d, 0xef, 0xfd, 0x1f, 0x42, 0xe1, 0x10,
+    0xc7, 0x5f, 0x14, 0x00, 0x00,
+};
+
+// web/index.html: 2703 bytes, 1013 gzipped
+const uint8_t INDEX_HTML_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x9d, 0x56, 0xed, 0x6e, 0xdb, 0x36,
+    0x14, 0xfd, 0xdf, 0xa7, 0xe0, 0x58, 0x0c, 0x4d, 0x86, 0x28, 0x96, 0x9c, 0x26, 0x69, 0x6c, 0xcb,
+    0x43, 0x90, 0x6e, 0x68, 0x81, 0x02, 0x2b, 0x96, 0x0c, 0x59, 0x7f, 0x52, 0x22, 0x65, 0x71, 0xa1,
+    0x48, 0x8e, 0xa4, 0xec, 0x78, 0x41, 0x81, 0x3d, 0xc4, 0x9e, 0x70, 0x4f, 0xb2, 0x4b, 0xea, 0xc3,
+    0xb2, 0xeb, 0xac, 0x69, 0xe0, 0x1f, 0x26, 0xa9, 0x73, 0x0f, 0x0f, 0x0f, 0x2f, 0x79, 0x39, 0xfb,
+    0xee, 0xed, 0x2f, 0x57, 0x37, 0x9f, 0x3e, 0xfe, 0x84, 0x4a, 0x57, 0x89, 0xf9, 0x6c, 0xbb, 0xfb,
+    0x02, 0xa1, 0xd9, 0xa6, 0xc1, 0x08, 0xf5, 0x0d, 0x68, 0x56, 0xcc, 0x11, 0x94, 0x97, 0xc4, 0x58,
+    0xe6, 0x52, 0x5c, 0xbb, 0x22, 0x7a, 0x83, 0x87, 0x9f, 0x24, 0xa9, 0x58, 0x8a, 0x97, 0x9c, 0xad,
+    0xb4, 0x32, 0x0e, 0xa3, 0x5c, 0x49, 0xc7, 0x24, 0x40, 0x57, 0x9c, 0xba, 0x32, 0xa5, 0x6c, 0xc9,
+    0x73, 0x16, 0x85, 0xce, 0x11, 0xe2, 0x92, 0x3b, 0x4e, 0x44, 0x64, 0x73, 0x22, 0x58, 0x9a, 0x74,
+    0x44, 0x8e, 0x3b, 0xc1, 0xe6, 0xbf, 0x7f, 0x8a, 0x3e, 0x24, 0xf1, 0xe5, 0xc8, 0xff, 0x9f, 0xc4,
+    0x97, 0xe8, 0x0a, 0x98, 0x8c, 0x12, 0xb3, 0x51, 0xf3, 0xb9, 0x81, 0x5a, 0xb7, 0xde, 0xd7, 0xfe,
+    0x01, 0x3d, 0xa0, 0x4c, 0xdd, 0x47, 0x96, 0xff, 0xc5, 0xe5, 0x62, 0x02, 0x6d, 0x43, 0x99, 0x89,
+    0x60, 0x68, 0x8a, 0x3e, 0x07, 0x44, 0xa6, 0xe8, 0x1a, 0x40, 0x05, 0x90, 0x46, 0x05, 0xa9, 0xb8,
+    0x58, 0x4f, 0xd0, 0xa5, 0x01, 0x31, 0x53, 0x54, 0x11, 0xb3, 0xe0, 0x72, 0x82, 0xc6, 0xb1, 0xee,
+    0xe1, 0x5c, 0xea, 0xda, 0x1d, 0xa1, 0xac, 0x76, 0x4e, 0x49, 0x88, 0xd3, 0x84, 0xd2, 0xc0, 0x9c,
+    0x00, 0x08, 0x05, 0x60, 0x17, 0x76, 0xda, 0x0d, 0x34, 0x91, 0xc7, 0x99, 0xf3, 0x01, 0x19, 0xc9,
+    0xef, 0x16, 0x46, 0xd5, 0x92, 0x46, 0xb9, 0x12, 0xca, 0x4c, 0xd0, 0xcb, 0x53, 0x72, 0xf6, 0xfa,
+    0xec, 0x64, 0xda, 0x76, 0x57, 0x25, 0x77, 0x6c, 0xda, 0x2a, 0x9d, 0x20, 0xa9, 0x24, 0x9b, 0x3a,
+    0x76, 0xef, 0x22, 0x67, 0x88, 0xb4, 0x85, 0x32, 0xd5, 0x04, 0xd5, 0x5a, 0x33, 0x93, 0x13, 0x0b,
+    0xb8, 0x20, 0x7c, 0xc5, 0xf8, 0xa2, 0x74, 0x13, 0x74, 0x1e, 0xc7, 0xd3, 0x4e, 0x52, 0x24, 0x58,
+    0x01, 0x43, 0x89, 0x61, 0xd5, 0x66, 0xcc, 0x34, 0xb8, 0x30, 0xb8, 0x91, 0x75, 0x4c, 0x89, 0x5c,
+    0x30, 0xb3, 0x5f, 0x1d, 0xbb, 0x88, 0x63, 0x4f, 0xdb, 0xc2, 0x1b, 0x68, 0xe4, 0x15, 0x01, 0x7e,
+    0x3f, 0x48, 0x90, 0x8c, 0x89, 0xce, 0xd4, 0x4e, 0x5b, 0xa6, 0x04, 0x9d, 0x22, 0xca, 0xad, 0x16,
+    0x04, 0x3c, 0xce, 0x84, 0xca, 0xef, 0x3a, 0xb3, 0x22, 0xa7, 0x34, 0xa8, 0x1a, 0x0f, 0xdc, 0x5a,
+    0x45, 0x49, 0x1c, 0xa3, 0x87, 0x90, 0x20, 0xde, 0xdd, 0xf8, 0xfb, 0x56, 0x70, 0xc1, 0x99, 0xa0,
+    0x90, 0x74, 0xc0, 0xdf, 0x45, 0x67, 0x0a, 0x76, 0xa3, 0xea, 0xd6, 0xba, 0x6f, 0x0d, 0xe7, 0xfe,
+    0xd7, 0x99, 0xba, 0x19, 0xce, 0xfc, 0xaf, 0x57, 0xcd, 0x16, 0x4c, 0x52, 0xf4, 0xb0, 0xa5, 0xfa,
+    0x62, 0xb3, 0xaa, 0xd9, 0x68, 0x98, 0x64, 0x9b, 0xce, 0x6c, 0xd4, 0x1d, 0x8b, 0x99, 0x4f, 0xa6,
+    0xf9, 0x8b, 0x4d, 0x2b, 0x20, 0xfd, 0x57, 0x66, 0xda, 0x0e, 0x41, 0xa5, 0x61, 0x45, 0x8a, 0x47,
+    0x70, 0x1e, 0x0a, 0xbe, 0xc0, 0xf3, 0x6b, 0xe6, 0x1c, 0xec, 0x8c, 0x9d, 0x8d, 0x48, 0x0b, 0xa1,
+    0x7c, 0x89, 0x38, 0x4d, 0x71, 0xf5, 0xa7, 0x73, 0xd7, 0x8e, 0xb8, 0xda, 0x62, 0x14, 0x26, 0x4b,
+    0xf1, 0x50, 0x5a, 0xe3, 0xe7, 0xc0, 0x3f, 0x9f, 0x81, 0x53, 0x3c, 0x9f, 0x8d, 0x80, 0x60, 0x87,
+    0x4a, 0xf0, 0x25, 0xeb, 0x49, 0x1e, 0x0d, 0x69, 0x17, 0xb6, 0xa5, 0xb7, 0xec, 0x1b, 0xe3, 0x70,
+    0x10, 0xef, 0xe1, 0x00, 0xfe, 0xfb, 0xf7, 0x3f, 0x9b, 0x43, 0x58, 0x26, 0xbb, 0xc8, 0xf6, 0x6c,
+    0xe4, 0x82, 0x58, 0x9b, 0x62, 0x48, 0x2f, 0x8c, 0x94, 0xcc, 0x05, 0xcf, 0xef, 0x52, 0x6c, 0xc1,
+    0xe1, 0x2b, 0x55, 0x55, 0x44, 0xd2, 0x83, 0x57, 0x4a, 0xbe, 0x3a, 0x42, 0x6c, 0x09, 0xb7, 0xc2,
+    0x21, 0x9e, 0x2b, 0x39, 0x1b, 0x35, 0x91, 0xdf, 0x4c, 0x53, 0x14, 0x43, 0x9e, 0xa2, 0x78, 0x2e,
+    0x91, 0x81, 0x85, 0x0f, 0x98, 0x7c, 0xf7, 0xb9, 0x54, 0xd6, 0x11, 0xe3, 0x06, 0x5c, 0xa1, 0xff,
+    0x7c, 0x32, 0xa5, 0xb7, 0xb8, 0x94, 0xde, 0xa6, 0xea, 0x37, 0xbb, 0xe9, 0x42, 0x3b, 0x5c, 0x53,
+    0xc8, 0xad, 0x35, 0xec, 0xb7, 0xac, 0xab, 0x8c, 0x19, 0xbf, 0xfd, 0x4c, 0xa7, 0x38, 0x3e, 0x4e,
+    0x70, 0xc8, 0x09, 0xba, 0xc2, 0x3d, 0xfc, 0xff, 0xa5, 0xb8, 0xb7, 0xb7, 0x07, 0xdd, 0xe4, 0x74,
+    0xb5, 0xb3, 0x8a, 0x61, 0xea, 0x7c, 0xa3, 0x82, 0x5a, 0x3f, 0x59, 0xc1, 0x6f, 0x1f, 0x7b, 0x05,
+    0xb5, 0x7e, 0x86, 0x02, 0xc7, 0x2b, 0xd6, 0x4c, 0xea, 0x5b, 0xe6, 0xc9, 0xf3, 0xde, 0x78, 0x74,
+    0x3f, 0x75, 0x88, 0xdd, 0x3b, 0xfb, 0xf6, 0x09, 0x18, 0xaa, 0xb0, 0x4c, 0xb0, 0xdc, 0x85, 0xa9,
+    0x4b, 0x0e, 0x5b, 0x67, 0xd6, 0x37, 0xdc, 0x7b, 0x01, 0xb3, 0x94, 0xfe, 0x2a, 0x85, 0xc3, 0xa9,
+    0x08, 0x7d, 0xd7, 0x7c, 0x3a, 0x38, 0xec, 0x95, 0x41, 0xa8, 0xd2, 0x8e, 0x83, 0xb6, 0x25, 0x11,
+    0x35, 0xc0, 0x0c, 0x81, 0x0d, 0xfb, 0x40, 0xac, 0x43, 0x96, 0x54, 0x5a, 0x30, 0xb8, 0x31, 0x1a,
+    0xc0, 0xa3, 0x11, 0x49, 0xd5, 0x06, 0x94, 0xaa, 0x36, 0xe8, 0x20, 0x41, 0x15, 0x97, 0x87, 0x5f,
+    0x8f, 0x3a, 0xed, 0xc2, 0xc6, 0xaf, 0x51, 0x09, 0x61, 0xa7, 0x7b, 0xe3, 0xe0, 0x02, 0x0c, 0x2b,
+    0x7b, 0x92, 0x93, 0x3b, 0x4b, 0x6c, 0x8d, 0x78, 0xdc, 0xc9, 0x9c, 0xc8, 0x25, 0xb1, 0xc1, 0x34,
+    0xff, 0xc4, 0xf0, 0xcf, 0x87, 0x86, 0x36, 0x54, 0x05, 0x8c, 0xca, 0x70, 0x05, 0x82, 0xd6, 0xb3,
+    0xb8, 0xbf, 0xd6, 0xda, 0x82, 0x69, 0x95, 0xe0, 0x14, 0x25, 0x50, 0x7b, 0x5f, 0xe6, 0x79, 0x1e,
+    0x2e, 0xb7, 0x86, 0x6d, 0x77, 0x93, 0x7c, 0x25, 0x6d, 0x5f, 0x29, 0xba, 0xce, 0x04, 0xb7, 0x25,
+    0xde, 0x9f, 0x3a, 0x50, 0xe9, 0x70, 0x0b, 0xac, 0x98, 0xb5, 0x64, 0xc1, 0xf6, 0x03, 0x6d, 0x9d,
+    0x55, 0x1c, 0xa0, 0xad, 0x8f, 0xd7, 0x70, 0x84, 0xbb, 0x87, 0xcc, 0xc8, 0x4f, 0xf6, 0xd5, 0x7b,
+    0x12, 0x35, 0xb5, 0x75, 0xe0, 0x5b, 0x28, 0x12, 0xa6, 0xfa, 0x95, 0x41, 0x2a, 0xde, 0xf2, 0x82,
+    0xf7, 0x99, 0x18, 0x46, 0xd0, 0xed, 0xfb, 0x9f, 0xdf, 0x23, 0x52, 0xbb, 0x72, 0xc7, 0xc9, 0x61,
+    0x22, 0x36, 0xa5, 0xa4, 0xd1, 0xbd, 0x29, 0x24, 0xb0, 0xa3, 0x51, 0x63, 0xe2, 0xe4, 0x24, 0xbc,
+    0x51, 0xbe, 0x70, 0x2f, 0x13, 0x64, 0xa7, 0x3e, 0x87, 0x62, 0xd1, 0x3f, 0x78, 0x4e, 0xbf, 0xac,
+    0x1c, 0x36, 0x37, 0x5c, 0x43, 0x7a, 0x9a, 0x1c, 0xea, 0x1b, 0xd1, 0xfa, 0xf8, 0x0f, 0xfb, 0xe3,
+    0x32, 0xbd, 0x38, 0x2f, 0x92, 0x22, 0x3e, 0xc9, 0xce, 0x13, 0x56, 0x5c, 0xb0, 0xf1, 0x1b, 0x1f,
+    0xd4, 0x20, 0x9b, 0xe2, 0xd9, 0x55, 0x4a, 0x28, 0x25, 0xe1, 0x99, 0xf9, 0x1f, 0xc5, 0x38, 0xfe,
+    0x51, 0x8f, 0x0a, 0x00, 0x00,
+};
+
+const WebAsset WEB_ASSETS[] = {
+    {"/app.js", "application/javascript", APP_JS_GZ, sizeof(APP_JS_GZ), "\"97f1f03b71ef9e28\"", true},
+    {"/", "text/html; charset=UTF-8", INDEX_HTML_GZ, sizeof(INDEX_HTML_GZ), "\"4eb800ff4a20d104\"", false},
+};
+
+#endif // WEB_ASSETS_H
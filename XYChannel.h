@@ -0,0 +1,26 @@
+#ifndef XY_CHANNEL_H
+#define XY_CHANNEL_H
+
+#include <Arduino.h>
+#include "XYUartIngest.h"
+#include "XYCommandQueue.h"
+#include "PublishPolicy.h"
+#include "TelemetryBatcher.h"
+
+// One XY-Lx0A unit of the bridge (XY_CHANNEL_COUNT in config.h): its own
+// UART ingest, command queue, publish policy and batch. All units share the
+// one MQTT/TLS connection and are told apart by `unit`, appended to their
+// topics ("<topic>/<unit>") and set in their payloads ("unit").
+struct XYChannel
+{
+    const char *unit = ""; // "" for a single unit: topics and payloads as before
+    XYUartIngest ingest;
+    XYCommandQueue commands;
+    PublishPolicy policy;
+    TelemetryBatcher batcher;
+    uint32_t lastDataLineUs = 0; // micros() when the last data line was read
+
+    bool named() const { return unit[0] != '\0'; }
+};
+
+#endif // XY_CHANNEL_H
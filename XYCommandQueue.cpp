@@ -0,0 +1,151 @@
+#include "XYCommandQueue.h"
+
+void XYCommandQueue::begin(Stream *port)
+{
+    _port = port;
+}
+
+void XYCommandQueue::onComplete(CompleteCallback cb)
+{
+    completeCallback = cb;
+}
+
+uint16_t XYCommandQueue::enqueue(const char *command, XYCommandOrigin origin, const char *ref)
+{
+    if (!_port || !command || !*command)
+        return 0;
+
+    XYCommand *slot = nullptr;
+    for (uint8_t i = 0; i < SLOTS; ++i)
+    {
+        if (slots[i].state == XY_CMD_FREE)
+        {
+            slot = &slots[i];
+            break;
+        }
+    }
+    if (!slot)
+        return 0;
+
+    slot->id = nextId++;
+    if (nextId == 0)
+        nextId = 1;
+    slot->origin = origin;
+    slot->state = XY_CMD_QUEUED;
+    strlcpy(slot->command, command, sizeof(slot->command));
+    strlcpy(slot->ref, ref ? ref : "", sizeof(slot->ref));
+    slot->response[0] = '\0';
+    slot->responseLen = 0;
+    slot->changedAt = millis();
+    return slot->id;
+}
+
+bool XYCommandQueue::onLine(const char *line)
+{
+    if (!inFlight)
+        return false;
+
+    XYCommand &cmd = *inFlight;
+    size_t free = sizeof(cmd.response) - 1 - cmd.responseLen;
+    if (cmd.responseLen > 0 && free > 0)
+    {
+        cmd.response[cmd.responseLen++] = '\n';
+        free--;
+    }
+    size_t len = strnlen(line, free);
+    memcpy(cmd.response + cmd.responseLen, line, len);
+    cmd.responseLen += len;
+    cmd.response[cmd.responseLen] = '\0';
+    cmd.changedAt = millis();
+    return true;
+}
+
+void XYCommandQueue::loop()
+{
+    unsigned long now = millis();
+
+    if (inFlight)
+    {
+        unsigned long idle = now - inFlight->changedAt;
+        if (inFlight->responseLen > 0 && idle >= QUIET_GAP_MS)
+        {
+            finish(*inFlight, XY_CMD_DONE);
+        }
+        else if (inFlight->responseLen == 0 && idle >= RESPONSE_TIMEOUT_MS)
+        {
+            finish(*inFlight, XY_CMD_TIMEOUT);
+        }
+    }
+
+    if (!inFlight)
+    {
+        XYCommand *cmd = nextQueued();
+        if (cmd)
+        {
+            _port->print(cmd->command);
+            cmd->state = XY_CMD_SENT;
+            cmd->changedAt = now;
+            inFlight = cmd;
+        }
+    }
+
+    // drop results nobody picked up
+    for (uint8_t i = 0; i < SLOTS; ++i)
+    {
+        XYCommand &cmd = slots[i];
+        if ((cmd.state == XY_CMD_DONE || cmd.state == XY_CMD_TIMEOUT) &&
+            now - cmd.changedAt >= RESULT_TTL_MS)
+        {
+            cmd.state = XY_CMD_FREE;
+        }
+    }
+}
+
+const XYCommand *XYCommandQueue::find(uint16_t id) const
+{
+    for (uint8_t i = 0; i < SLOTS; ++i)
+    {
+        if (slots[i].state != XY_CMD_FREE && slots[i].id == id)
+            return &slots[i];
+    }
+    return nullptr;
+}
+
+void XYCommandQueue::release(uint16_t id)
+{
+    for (uint8_t i = 0; i < SLOTS; ++i)
+    {
+        XYCommand &cmd = slots[i];
+        if (cmd.id == id && (cmd.state == XY_CMD_DONE || cmd.state == XY_CMD_TIMEOUT))
+            cmd.state = XY_CMD_FREE;
+    }
+}
+
+// oldest queued command first (ids grow, wrap is handled by the 16-bit distance)
+XYCommand *XYCommandQueue::nextQueued()
+{
+    XYCommand *oldest = nullptr;
+    for (uint8_t i = 0; i < SLOTS; ++i)
+    {
+        XYCommand &cmd = slots[i];
+        if (cmd.state != XY_CMD_QUEUED)
+            continue;
+        if (!oldest || (int16_t)(cmd.id - oldest->id) < 0)
+            oldest = &cmd;
+    }
+    return oldest;
+}
+
+void XYCommandQueue::finish(XYCommand &cmd, XYCommandState state)
+{
+    cmd.state = state;
+    cmd.changedAt = millis();
+    inFlight = nullptr;
+
+    if (completeCallback)
+        completeCallback(cmd);
+
+    // MQTT replies are published by the callback, nothing to keep
+    if (cmd.origin == XY_CMD_MQTT)
+        cmd.state = XY_CMD_FREE;
+}
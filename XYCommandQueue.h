@@ -0,0 +1,76 @@
+#ifndef XY_COMMAND_QUEUE_H
+#define XY_COMMAND_QUEUE_H
+
+#include <Arduino.h>
+#include <functional>
+
+enum XYCommandOrigin : uint8_t
+{
+    XY_CMD_HTTP = 0,
+    XY_CMD_MQTT,
+};
+
+enum XYCommandState : uint8_t
+{
+    XY_CMD_FREE = 0,
+    XY_CMD_QUEUED,  // waiting for the UART
+    XY_CMD_SENT,    // written, collecting reply lines
+    XY_CMD_DONE,    // reply complete
+    XY_CMD_TIMEOUT, // no reply within RESPONSE_TIMEOUT_MS
+};
+
+struct XYCommand
+{
+    uint16_t id;
+    XYCommandOrigin origin;
+    XYCommandState state;
+    char command[48];
+    char ref[24]; // correlation id of an MQTT command, "" if none
+    char response[128];
+    size_t responseLen;
+    unsigned long changedAt; // enqueue / send / last reply line / completion time
+};
+
+// Serializes commands to the XY-L10A/XY-L30A UART without blocking loop():
+// one command is in flight at a time, reply lines are routed to it by
+// onLine(), and it completes after a quiet gap or a timeout.
+class XYCommandQueue
+{
+public:
+    static const uint8_t SLOTS = 6;
+    static const unsigned long RESPONSE_TIMEOUT_MS = 500;
+    static const unsigned long QUIET_GAP_MS = 100;
+    static const unsigned long RESULT_TTL_MS = 10000; // unread results are dropped after
+
+    typedef std::function<void(const XYCommand &)> CompleteCallback;
+
+    void begin(Stream *port);
+    void onComplete(CompleteCallback cb);
+
+    // returns the command id, 0 if the queue is full or there is no port
+    uint16_t enqueue(const char *command, XYCommandOrigin origin, const char *ref = nullptr);
+
+    // feeds a reply line, returns false if no command is waiting for one
+    bool onLine(const char *line);
+
+    void loop();
+
+    // nullptr if the id is unknown or expired
+    const XYCommand *find(uint16_t id) const;
+    // frees a finished command once its result was delivered
+    void release(uint16_t id);
+
+    Stream *port() const { return _port; }
+
+private:
+    XYCommand slots[SLOTS] = {};
+    Stream *_port = nullptr;
+    XYCommand *inFlight = nullptr;
+    uint16_t nextId = 1;
+    CompleteCallback completeCallback;
+
+    XYCommand *nextQueued();
+    void finish(XYCommand &cmd, XYCommandState state);
+};
+
+#endif // XY_COMMAND_QUEUE_H
@@ -1,41 +1,265 @@
 #include "XYParser.h"
 
-bool XYParser::parse(const char *line, XYPacket &packet)
+// Line example: "12.5V,100%,00:00,CL"
+namespace
 {
-    char buffer[64];
-    strncpy(buffer, line, sizeof(buffer));
-    buffer[sizeof(buffer) - 1] = '\0';
+    inline bool isDelimiter(char c)
+    {
+        return c == ' ' || c == ',' || c == ':' || c == '%' || c == '\r' || c == '\n';
+    }
+
+    inline bool isDigit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    inline bool isUpper(char c)
+    {
+        return c >= 'A' && c <= 'Z';
+    }
+
+    // "hh:mm" / "h:mm", nothing else in the token
+    bool isTimerToken(const char *token, size_t len)
+    {
+        if (len < 4 || len > 5 || token[len - 3] != ':')
+            return false;
+        for (size_t i = 0; i < len; i++)
+        {
+            if (i != len - 3 && !isDigit(token[i]))
+                return false;
+        }
+        return true;
+    }
+
+    // uint16_t centivolts hold 655.35 V at most
+    const uint16_t MAX_WHOLE_VOLTS = 655;
+
+    inline const char *skipDelimiters(const char *p)
+    {
+        while (*p && isDelimiter(*p))
+            p++;
+        return p;
+    }
+
+    // Field must be followed by a delimiter or the end of the line
+    inline bool atFieldEnd(const char *p)
+    {
+        return *p == '\0' || isDelimiter(*p);
+    }
+
+    // Reads 1..maxDigits decimal digits, nullptr if there is no digit
+    const char *readUnsigned(const char *p, uint8_t maxDigits, uint16_t &out)
+    {
+        uint16_t value = 0;
+        uint8_t n = 0;
+        while (n < maxDigits && isDigit(*p))
+        {
+            value = value * 10 + (*p - '0');
+            p++;
+            n++;
+        }
+        if (n == 0)
+            return nullptr;
+        out = value;
+        return p;
+    }
 
-    const char *delimiters = " ,:%";
-    char *token = strtok(buffer, delimiters);
-    int field = 0;
+    // Two-char config keys packed into one integer, resolved by a switch
+    constexpr uint16_t keyCode(char a, char b)
+    {
+        return (uint16_t)((uint8_t)a << 8 | (uint8_t)b);
+    }
 
-    while (token != nullptr)
+    inline XYConfigKey lookupKey(char a, char b)
     {
-        switch (field)
+        switch (keyCode(a, b))
         {
-        case 0:
-            packet.voltage = atof(token);
-            break;
-        case 1:
-            packet.percent = atoi(token);
-            break;
-        case 2:
-            packet.hours = atoi(token);
-            break;
-        case 3:
-            packet.minutes = atoi(token);
-            break;
-        case 4:
-            strncpy(packet.state, token, 2);
-            packet.state[2] = '\0';
-            break;
+        case keyCode('d', 'w'):
+            return XY_KEY_DW;
+        case keyCode('u', 'p'):
+            return XY_KEY_UP;
+        case keyCode('t', 'h'):
+            return XY_KEY_TH;
+        case keyCode('s', 't'):
+            return XY_KEY_ST;
+        case keyCode('e', 't'):
+            return XY_KEY_ET;
         default:
-            return false;
+            return XY_KEY_COUNT;
         }
-        token = strtok(nullptr, delimiters);
-        field++;
     }
 
-    return (field == 5);
+    const char *const CONFIG_KEY_NAMES[XY_KEY_COUNT] = {"dw", "up", "th", "st", "et", "timer"};
+
+    const char *readVoltage(const char *p, uint16_t &centivolts)
+    {
+        uint16_t whole = 0;
+        p = readUnsigned(p, 3, whole);
+        if (!p || whole > MAX_WHOLE_VOLTS)
+            return nullptr;
+
+        uint16_t fraction = 0;
+        if (*p == '.')
+        {
+            p++;
+            if (isDigit(*p))
+            {
+                fraction = (*p++ - '0') * 10;
+                if (isDigit(*p))
+                    fraction += *p++ - '0';
+                // more precision than 0.01V is dropped
+                while (isDigit(*p))
+                    p++;
+            }
+        }
+
+        if (*p == 'V' || *p == 'v')
+            p++;
+
+        centivolts = whole * 100 + fraction;
+        return p;
+    }
+}
+
+XYParseResult XYParser::decode(const char *line, XYPacket &packet)
+{
+    uint16_t value = 0;
+    const char *p = skipDelimiters(line);
+
+    // 1. voltage
+    p = readVoltage(p, packet.centivolts);
+    if (!p || !atFieldEnd(p))
+        return packet.error = XY_PARSE_ERR_VOLTAGE;
+
+    // 2. percent
+    p = readUnsigned(skipDelimiters(p), 3, value);
+    if (!p || !atFieldEnd(p) || value > 100)
+        return packet.error = XY_PARSE_ERR_PERCENT;
+    packet.percent = value;
+
+    // 3. hours
+    p = readUnsigned(skipDelimiters(p), 2, value);
+    if (!p || !atFieldEnd(p))
+        return packet.error = XY_PARSE_ERR_HOURS;
+    packet.hours = value;
+
+    // 4. minutes
+    p = readUnsigned(skipDelimiters(p), 2, value);
+    if (!p || !atFieldEnd(p) || value > 59)
+        return packet.error = XY_PARSE_ERR_MINUTES;
+    packet.minutes = value;
+
+    // 5. state (first two chars of the token, "OP"/"CL"; letters only,
+    //    a flipped bit must not end up as a new state)
+    p = skipDelimiters(p);
+    if (atFieldEnd(p))
+        return packet.error = XY_PARSE_ERR_STATE;
+    uint8_t n = 0;
+    while (!atFieldEnd(p))
+    {
+        if (!isUpper(*p))
+            return packet.error = XY_PARSE_ERR_STATE;
+        if (n < sizeof(packet.state) - 1)
+            packet.state[n++] = *p;
+        p++;
+    }
+    packet.state[n] = '\0';
+
+    if (*skipDelimiters(p) != '\0')
+        return packet.error = XY_PARSE_ERR_TRAILING;
+
+    return packet.error = XY_PARSE_OK;
+}
+
+bool XYParser::parse(const char *line, XYPacket &packet)
+{
+    return decode(line, packet) == XY_PARSE_OK;
+}
+
+XYFrameType XYParser::classify(const char *line, XYFrame &frame)
+{
+    const char *p = skipDelimiters(line);
+
+    // Data lines always start with the voltage digits, config echoes never do
+    if (isDigit(*p) && decode(p, frame.packet) == XY_PARSE_OK)
+        return frame.type = XY_FRAME_DATA;
+
+    // Config tokens are comma separated: "dw10.0,up12.5,00:00"
+    XYConfigParams &config = frame.config;
+    config.mask = 0;
+    uint8_t unknownTokens = 0;
+    p = line;
+
+    while (*p && *p != '\r' && *p != '\n')
+    {
+        const char *token = p;
+        while (*p && *p != ',' && *p != '\r' && *p != '\n')
+            p++;
+        size_t len = p - token;
+        if (*p == ',')
+            p++;
+
+        XYConfigKey key = len >= 2 ? lookupKey(token[0], token[1]) : XY_KEY_COUNT;
+        const char *value = token + 2;
+        if (key == XY_KEY_COUNT)
+        {
+            if (!isTimerToken(token, len))
+            {
+                unknownTokens++;
+                continue;
+            }
+            key = XY_KEY_TIMER;
+            value = token;
+        }
+
+        size_t valueLen = token + len - value;
+        char *out = config.values[key];
+        if (valueLen > sizeof(config.values[key]) - 1)
+            valueLen = sizeof(config.values[key]) - 1;
+        memcpy(out, value, valueLen);
+        out[valueLen] = '\0';
+        config.mask |= (1 << key);
+    }
+
+    // a damaged data line still holds an "hh:mm" token, a timer alone
+    // is only an echo when nothing else is on the line
+    if (config.mask == (1 << XY_KEY_TIMER) && unknownTokens)
+        config.mask = 0;
+
+    return frame.type = config.mask ? XY_FRAME_CONFIG : XY_FRAME_RAW;
+}
+
+const char *XYParser::configKeyName(XYConfigKey key)
+{
+    return key < XY_KEY_COUNT ? CONFIG_KEY_NAMES[key] : nullptr;
+}
+
+size_t XYParser::formatVoltage(uint16_t centivolts, char *out, size_t size)
+{
+    int len = snprintf_P(out, size, PSTR("%u.%02u"), centivolts / 100, centivolts % 100);
+    if (len < 0)
+        return 0;
+    return (size_t)len < size ? (size_t)len : size - 1;
+}
+
+const char *XYParser::errorName(XYParseResult result)
+{
+    switch (result)
+    {
+    case XY_PARSE_OK:
+        return "ok";
+    case XY_PARSE_ERR_VOLTAGE:
+        return "voltage";
+    case XY_PARSE_ERR_PERCENT:
+        return "percent";
+    case XY_PARSE_ERR_HOURS:
+        return "hours";
+    case XY_PARSE_ERR_MINUTES:
+        return "minutes";
+    case XY_PARSE_ERR_STATE:
+        return "state";
+    case XY_PARSE_ERR_TRAILING:
+        return "trailing";
+    }
+    return "unknown";
 }
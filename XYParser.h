@@ -3,19 +3,78 @@
 
 #include <Arduino.h>
 
+// Result of XYParser::decode, names the field that failed
+enum XYParseResult : uint8_t
+{
+    XY_PARSE_OK = 0,
+    XY_PARSE_ERR_VOLTAGE,
+    XY_PARSE_ERR_PERCENT,
+    XY_PARSE_ERR_HOURS,
+    XY_PARSE_ERR_MINUTES,
+    XY_PARSE_ERR_STATE,
+    XY_PARSE_ERR_TRAILING,
+};
+
 struct XYPacket
 {
-    float voltage; // ex: 00.0V
-    int percent;   // ex: 000
-    int hours;     // ex: 00
-    int minutes;   // ex: 00
-    char state[3]; // ex: "CL"
+    uint16_t centivolts; // ex: 12.5V -> 1250 (fixed-point, 0.01V)
+    int percent;         // ex: 000
+    int hours;           // ex: 00
+    int minutes;         // ex: 00
+    char state[3];       // ex: "CL"
+    XYParseResult error; // last decode result
+};
+
+// Kind of UART line, see XYParser::classify
+enum XYFrameType : uint8_t
+{
+    XY_FRAME_RAW = 0,
+    XY_FRAME_DATA,
+    XY_FRAME_CONFIG,
+};
+
+// Config echo keys (after "read"), e.g. "dw10.0,up12.5,00:00"
+enum XYConfigKey : uint8_t
+{
+    XY_KEY_DW = 0,
+    XY_KEY_UP,
+    XY_KEY_TH,
+    XY_KEY_ST,
+    XY_KEY_ET,
+    XY_KEY_TIMER,
+    XY_KEY_COUNT,
+};
+
+struct XYConfigParams
+{
+    uint8_t mask; // bit (1 << XYConfigKey) is set for each key present
+    char values[XY_KEY_COUNT][12];
+};
+
+struct XYFrame
+{
+    XYFrameType type;
+    XYPacket packet;       // valid for XY_FRAME_DATA
+    XYConfigParams config; // valid for XY_FRAME_CONFIG
 };
 
 class XYParser
 {
 public:
+    // Single pass over the line, no copy, no float math
+    static XYParseResult decode(const char *line, XYPacket &packet);
+
     static bool parse(const char *line, XYPacket &packet);
+
+    // One pass per line: data packet, config params or raw
+    static XYFrameType classify(const char *line, XYFrame &frame);
+
+    static const char *configKeyName(XYConfigKey key);
+
+    // "12.50" from 1250, returns number of chars written
+    static size_t formatVoltage(uint16_t centivolts, char *out, size_t size);
+
+    static const char *errorName(XYParseResult result);
 };
 
 #endif // XYPARSER_H
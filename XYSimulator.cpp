@@ -0,0 +1,305 @@
+#include "XYSimulator.h"
+
+namespace
+{
+    // "11.5" / "11" -> 0.01 V, 0 if not a number
+    uint16_t parseVoltage(const char *s)
+    {
+        uint16_t whole = 0;
+        uint16_t fraction = 0;
+        while (*s >= '0' && *s <= '9')
+            whole = whole * 10 + (*s++ - '0');
+        if (*s == '.' && s[1] >= '0' && s[1] <= '9')
+            fraction = (s[1] - '0') * 10;
+        return whole * 100 + fraction;
+    }
+}
+
+void XYSimulator::begin(unsigned long intervalMs, uint16_t speedupFactor)
+{
+    interval = intervalMs ? intervalMs : 1;
+    speedup = speedupFactor ? speedupFactor : 1;
+    lastTick = millis();
+    lastLine = lastTick;
+}
+
+bool XYSimulator::replay(FS &fs, const char *path)
+{
+    trace = fs.open(path, "r");
+    if (!trace)
+        return false;
+    traceDue = millis();
+    return readTraceRow();
+}
+
+void XYSimulator::setNoise(uint16_t perMille, uint32_t seed)
+{
+    noisePerMille = perMille;
+    rng = seed ? seed : 1;
+}
+
+int XYSimulator::available()
+{
+    tick();
+    return out.size();
+}
+
+int XYSimulator::read()
+{
+    uint8_t c;
+    return out.pop(c) ? c : -1;
+}
+
+int XYSimulator::peek()
+{
+    // the ingest never peeks, a line-based stand-in does not need it
+    return -1;
+}
+
+size_t XYSimulator::write(uint8_t c)
+{
+    return write(&c, 1);
+}
+
+// commands come without a line end, a command ends with the first tick after it
+size_t XYSimulator::write(const uint8_t *buf, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        if (commandLen < sizeof(command) - 1)
+            command[commandLen++] = buf[i];
+    }
+    command[commandLen] = '\0';
+    commandAt = millis();
+    return size;
+}
+
+void XYSimulator::tick()
+{
+    unsigned long now = millis();
+
+    if (commandLen && now - commandAt >= REPLY_DELAY_MS)
+        handleCommand();
+
+    if (trace)
+    {
+        replayTick();
+        return;
+    }
+
+    stepModel((now - lastTick) * speedup);
+    lastTick = now;
+
+    if (streaming && now - lastLine >= interval)
+    {
+        lastLine = now;
+        emitData();
+    }
+}
+
+void XYSimulator::stepModel(uint32_t ms)
+{
+    if (outputOn && enabled)
+        timerMs += ms;
+
+    // 1 cV per simulated second, up while charging, down while discharging
+    carryMs += ms;
+    uint32_t steps = carryMs / 1000;
+    carryMs %= 1000;
+
+    for (uint32_t i = 0; i < steps; i++)
+    {
+        if (outputOn && enabled)
+        {
+            centivolts++;
+            if (centivolts >= up)
+                outputOn = false;
+        }
+        else
+        {
+            if (centivolts > 0)
+                centivolts--;
+            if (centivolts <= dw)
+                outputOn = true;
+        }
+    }
+}
+
+void XYSimulator::emitData()
+{
+    int percent = 0;
+    if (centivolts >= up)
+        percent = 100;
+    else if (centivolts > dw)
+        percent = (uint32_t)(centivolts - dw) * 100 / (up - dw);
+
+    uint32_t timerMinutes = timerMs / 60000;
+    char line[40];
+    snprintf_P(line, sizeof(line), PSTR("%u.%uV,%03d%%,%02u:%02u,%s"),
+               centivolts / 100, (centivolts % 100) / 10, percent,
+               (unsigned)(timerMinutes / 60 % 100), (unsigned)(timerMinutes % 60),
+               outputOn && enabled ? "OP" : "CL");
+    emit(line);
+}
+
+void XYSimulator::emitConfig()
+{
+    uint32_t timerMinutes = timerMs / 60000;
+    char line[40];
+    snprintf_P(line, sizeof(line), PSTR("dw%u.%u,up%u.%u,%02u:%02u"),
+               dw / 100, (dw % 100) / 10, up / 100, (up % 100) / 10,
+               (unsigned)(timerMinutes / 60 % 100), (unsigned)(timerMinutes % 60));
+    emit(line);
+}
+
+void XYSimulator::handleCommand()
+{
+    const char *cmd = command;
+    _stats.commands++;
+
+    if (strcmp(cmd, "read") == 0)
+    {
+        emitConfig();
+    }
+    else if (strncmp(cmd, "dw", 2) == 0 && parseVoltage(cmd + 2))
+    {
+        dw = parseVoltage(cmd + 2);
+        emit("DOWN");
+    }
+    else if (strncmp(cmd, "up", 2) == 0 && parseVoltage(cmd + 2))
+    {
+        up = parseVoltage(cmd + 2);
+        emit("DOWN");
+    }
+    else if (strcmp(cmd, "on") == 0 || strcmp(cmd, "off") == 0)
+    {
+        enabled = cmd[1] == 'n';
+        emit("DOWN");
+    }
+    else if (strcmp(cmd, "start") == 0 || strcmp(cmd, "stop") == 0)
+    {
+        streaming = cmd[2] == 'a';
+        emit("DOWN");
+    }
+    else if (strlen(cmd) == 5 && cmd[2] == ':')
+    {
+        timerMs = (uint32_t)(atoi(cmd) * 60 + atoi(cmd + 3)) * 60000;
+        emit("DOWN");
+    }
+    else
+    {
+        emit("FAIL");
+    }
+
+    commandLen = 0;
+    command[0] = '\0';
+}
+
+void XYSimulator::replayTick()
+{
+    // a fast trace may be due several rows at once
+    for (uint8_t rows = 0; rows < MAX_TRACE_ROWS_PER_TICK && trace && (long)(millis() - traceDue) >= 0; rows++)
+    {
+        emit(traceLine);
+        if (!readTraceRow())
+            break;
+    }
+}
+
+// "<delay_ms> <line>", the delay is from the previous row; loops at the end
+bool XYSimulator::readTraceRow()
+{
+    for (uint8_t attempt = 0; attempt < 2; attempt++)
+    {
+        while (trace.available())
+        {
+            size_t len = trace.readBytesUntil('\n', traceLine, sizeof(traceLine) - 1);
+            traceLine[len] = '\0';
+            if (len && traceLine[len - 1] == '\r')
+                traceLine[--len] = '\0';
+
+            char *line = nullptr;
+            unsigned long delayMs = strtoul(traceLine, &line, 10);
+            if (line == traceLine || *line != ' ')
+                continue; // blank or comment row
+
+            memmove(traceLine, line + 1, strlen(line));
+            traceDue += delayMs / speedup;
+            return true;
+        }
+        trace.seek(0);
+    }
+
+    // nothing usable in the file
+    trace.close();
+    return false;
+}
+
+// xorshift32, 0..range-1
+uint32_t XYSimulator::random(uint32_t range)
+{
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng % range;
+}
+
+void XYSimulator::emitDamaged(const char *line)
+{
+    char damaged[LONG_LINE_SIZE];
+    size_t len = strlen(line);
+    if (len > sizeof(damaged))
+        len = sizeof(damaged);
+    memcpy(damaged, line, len);
+    _stats.damaged++;
+
+    switch (random(3))
+    {
+    case 0:
+        // one flipped bit anywhere in the line
+        if (len)
+            damaged[random(len)] ^= 1 << random(8);
+        send(damaged, len, true);
+        break;
+
+    case 1:
+        // cut before its end and without "\r\n": runs into the next line
+        send(damaged, len ? random(len) : 0, false);
+        break;
+
+    default:
+        // repeated until it is longer than the ingest line buffer
+        for (size_t i = len; len && i < sizeof(damaged); i++)
+            damaged[i] = line[i % len];
+        send(damaged, len ? sizeof(damaged) : 0, true);
+        break;
+    }
+}
+
+void XYSimulator::emit(const char *line)
+{
+    if (noisePerMille && random(1000) < noisePerMille)
+    {
+        emitDamaged(line);
+        return;
+    }
+    send(line, strlen(line), true);
+}
+
+void XYSimulator::send(const char *bytes, size_t len, bool lineEnd)
+{
+    if ((size_t)(OUT_SIZE - out.size()) < len + 2)
+    {
+        _stats.overruns++;
+        return;
+    }
+
+    for (size_t i = 0; i < len; i++)
+        out.push((uint8_t)bytes[i]);
+    if (lineEnd)
+    {
+        out.push('\r');
+        out.push('\n');
+    }
+    _stats.lines++;
+}
@@ -0,0 +1,93 @@
+#ifndef XY_SIMULATOR_H
+#define XY_SIMULATOR_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include "SpscRing.h"
+
+struct XYSimulatorStats
+{
+    uint32_t lines;    // lines emitted
+    uint32_t commands; // commands answered
+    uint32_t overruns; // lines dropped because the reader fell behind
+    uint32_t damaged;  // lines sent with injected noise
+};
+
+// Stand-in for the XY-L10A/XY-L30A UART (XY_SIMULATOR in config.h).
+// It is a Stream, so it plugs in where SoftwareSerial/Serial would and
+// its lines go through the real ingest, parser, policy and publish path.
+//  - model: battery voltage swings between dw and up, output "OP" while
+//    charging and "CL" while discharging, one data line per interval
+//  - commands: read, dwX.X, upX.X, hh:mm, on, off, start, stop
+//  - replay: a LittleFS trace of "<delay_ms> <line>" rows, looped
+//  - noise: optional damaged lines to exercise the decoders
+// speedup scales simulated time (and trace delays) against millis().
+class XYSimulator : public Stream
+{
+public:
+    static const uint16_t OUT_SIZE = 512;
+    static const unsigned long REPLY_DELAY_MS = 30;
+    static const uint8_t MAX_TRACE_ROWS_PER_TICK = 8;
+    static const uint8_t LONG_LINE_SIZE = 120; // over XYUartIngest::LINE_SIZE
+
+    void begin(unsigned long intervalMs, uint16_t speedup);
+    // replays a trace instead of the model, false if it cannot be opened
+    bool replay(FS &fs, const char *path);
+    // damages perMille of the lines (bit flip, cut line, long line),
+    // the same seed gives the same damage
+    void setNoise(uint16_t perMille, uint32_t seed);
+
+    const XYSimulatorStats &stats() const { return _stats; }
+
+    // Stream
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buf, size_t size) override;
+    void flush() override {}
+
+private:
+    SpscRing<uint8_t, OUT_SIZE> out;
+    XYSimulatorStats _stats = {0, 0, 0, 0};
+
+    unsigned long interval = 1000;
+    uint16_t speedup = 1;
+    unsigned long lastTick = 0;
+    unsigned long lastLine = 0;
+
+    // model state, 0.01 V
+    uint16_t centivolts = 1200;
+    uint16_t dw = 1100;
+    uint16_t up = 1300;
+    bool outputOn = true;  // "OP"
+    bool enabled = true;   // on/off
+    bool streaming = true; // start/stop
+    uint32_t carryMs = 0;  // simulated time not yet turned into a voltage step
+    uint32_t timerMs = 0;  // output-on time, shown as hh:mm
+
+    char command[48] = {0};
+    size_t commandLen = 0;
+    unsigned long commandAt = 0;
+
+    File trace;
+    unsigned long traceDue = 0;
+    char traceLine[128] = {0};
+
+    uint16_t noisePerMille = 0;
+    uint32_t rng = 1;
+
+    void tick();
+    void stepModel(uint32_t ms);
+    void emitData();
+    void emitConfig();
+    void handleCommand();
+    void replayTick();
+    bool readTraceRow();
+    void emit(const char *line);
+    void emitDamaged(const char *line);
+    void send(const char *bytes, size_t len, bool lineEnd);
+    uint32_t random(uint32_t range);
+};
+
+#endif // XY_SIMULATOR_H
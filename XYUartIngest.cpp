@@ -0,0 +1,95 @@
+#include "XYUartIngest.h"
+#include <Schedule.h>
+
+void XYUartIngest::begin(Stream *port)
+{
+    _port = port;
+    rateStart = millis();
+
+    // interval 0: run on every loop() end and every yield()/delay()
+    schedule_recurrent_function_us([this]()
+                                   {
+                                       pump();
+                                       return true;
+                                   },
+                                   0);
+}
+
+void XYUartIngest::pump()
+{
+    if (!_port)
+        return;
+
+    while (_port->available() > 0)
+    {
+        uint8_t c = _port->read();
+        _stats.bytes++;
+        if (!ring.push(c))
+            _stats.overruns++;
+    }
+}
+
+size_t XYUartIngest::readLine(char *out, size_t size)
+{
+    uint8_t c;
+    while (ring.pop(c))
+    {
+        if (c == '\n')
+        {
+            size_t len = lineLen;
+            bool dropped = discarding;
+            bool noise = garbled;
+            lineLen = 0;
+            discarding = false;
+            garbled = false;
+
+            if (dropped || len == 0)
+                continue;
+            if (noise)
+            {
+                _stats.garbledLines++;
+                continue;
+            }
+
+            if (len >= size)
+                len = size - 1;
+            memcpy(out, line, len);
+            out[len] = '\0';
+            _stats.lines++;
+            return len;
+        }
+
+        if (c == '\r' || discarding)
+            continue;
+
+        // the module only sends printable ASCII
+        if (c < 0x20 || c > 0x7E)
+            garbled = true;
+
+        if (lineLen < sizeof(line) - 1)
+        {
+            line[lineLen++] = c;
+        }
+        else
+        {
+            // line is too long: drop it up to the next '\n'
+            discarding = true;
+            lineLen = 0;
+            _stats.truncatedLines++;
+        }
+    }
+    return 0;
+}
+
+const XYUartStats &XYUartIngest::stats()
+{
+    unsigned long now = millis();
+    unsigned long elapsed = now - rateStart;
+    if (elapsed >= 1000)
+    {
+        _stats.bytesPerSec = (uint32_t)((uint64_t)(_stats.bytes - rateBytes) * 1000 / elapsed);
+        rateBytes = _stats.bytes;
+        rateStart = now;
+    }
+    return _stats;
+}
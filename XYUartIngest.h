@@ -0,0 +1,54 @@
+#ifndef XY_UART_INGEST_H
+#define XY_UART_INGEST_H
+
+#include <Arduino.h>
+#include "SpscRing.h"
+
+struct XYUartStats
+{
+    uint32_t bytes;          // total bytes received
+    uint32_t lines;          // complete lines handed out
+    uint32_t overruns;       // bytes dropped because the ring was full
+    uint32_t truncatedLines; // lines longer than LINE_SIZE - 1, dropped
+    uint32_t garbledLines;   // lines with control or non-ASCII bytes (line noise), dropped
+    uint32_t bytesPerSec;    // averaged since the previous stats() call (>= 1 s)
+};
+
+// UART ingestion for XY-L10A/XY-L30A:
+// pump() moves bytes from the port into a lock-free ring (also runs on every
+// yield()/delay() via a recurrent scheduled function, so slow Wi-Fi/TLS work
+// in loop() does not overflow the small port buffer),
+// readLine() drains the ring one complete line at a time.
+class XYUartIngest
+{
+public:
+    static const uint16_t RING_SIZE = 512;
+    static const size_t LINE_SIZE = 96;
+
+    void begin(Stream *port);
+
+    // producer side
+    void pump();
+
+    // consumer side: copies the next complete line (without "\r\n") to out,
+    // returns its length or 0 if no complete line is buffered yet
+    size_t readLine(char *out, size_t size);
+
+    Stream *port() const { return _port; }
+    const XYUartStats &stats();
+
+private:
+    SpscRing<uint8_t, RING_SIZE> ring;
+    Stream *_port = nullptr;
+
+    char line[LINE_SIZE] = {0};
+    size_t lineLen = 0;
+    bool discarding = false;
+    bool garbled = false;
+
+    XYUartStats _stats = {0, 0, 0, 0, 0, 0};
+    uint32_t rateBytes = 0;
+    unsigned long rateStart = 0;
+};
+
+#endif // XY_UART_INGEST_H
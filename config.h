@@ -6,6 +6,75 @@
 // false:  Serial.print  do not work
 #define IS_SERIAL_DEBUG false
 
+// XY-L10A/XY-L30A UART port
+// false: SoftwareSerial on GPIO3/GPIO1
+// true:  hardware UART0 (interrupt driven, 256 byte RX buffer)
+#define XY_UART_HARDWARE false
+// with XY_UART_HARDWARE: move UART0 to RX = GPIO13, TX = GPIO15 (Serial.swap())
+#define XY_UART_SWAP_PINS false
+#define XY_UART_BAUD 9600
+
+// XY-L30A simulator instead of the UART (development / load tests):
+// one data line every XY_SIMULATOR_INTERVAL_MS, simulated time runs
+// XY_SIMULATOR_SPEEDUP times faster; if XY_SIMULATOR_TRACE exists on
+// LittleFS it is replayed instead ("<delay_ms> <line>" rows, looped)
+#define XY_SIMULATOR false
+#define XY_SIMULATOR_INTERVAL_MS 1000
+#define XY_SIMULATOR_SPEEDUP 1
+#define XY_SIMULATOR_TRACE "/xy-trace.txt"
+// per mille of simulated lines damaged like a noisy UART would:
+// a flipped bit, a line cut before its end, or a line over LINE_SIZE
+#define XY_SIMULATOR_NOISE 0
+
+// Multi-channel bridge: XY_CHANNEL_COUNT (1..4) XY-Lx0A units on one ESP8266,
+// sharing one MQTT/TLS connection. Channel 0 is the UART above, channel n
+// a SoftwareSerial on XY_CHANNEL_RX_PINS[n - 1]/XY_CHANNEL_TX_PINS[n - 1]
+// (with XY_SIMULATOR every channel gets its own simulator). With more than
+// one channel, unit n publishes on "<topic>/<XY_CHANNEL_UNITS[n]>", sets
+// "unit" in its payloads and takes commands addressed to that unit.
+// GPIO13/15 are taken by XY_UART_SWAP_PINS.
+#define XY_CHANNEL_COUNT 1
+const uint8_t XY_CHANNEL_RX_PINS[] = {4, 12, 13};
+const uint8_t XY_CHANNEL_TX_PINS[] = {5, 14, 16};
+const char *const XY_CHANNEL_UNITS[] = {"1", "2", "3", "4"};
+
+// Fast boot: no start-up delays, direct join to the cached BSSID/channel
+// (full scan as fallback), NTP in the background
+#define FAST_BOOT true
+// with FAST_BOOT: also reuse the last DHCP lease as a static IP
+#define FAST_BOOT_STATIC_IP false
+#define FAST_JOIN_TIMEOUT_MS 4000
+
+// TLS to the MQTT broker: Maximum Fragment Length (512/1024/2048/4096, 0 = off)
+// shrinks BearSSL RX/TX buffers from ~17 KB to ~1 KB when the broker supports it
+#define TLS_MFLN_SIZE 512
+// DANGER!!! no certificate check, only for tests against a local broker
+#define MQTT_TLS_INSECURE false
+
+// MQTT reconnects: the n-th retry waits a random time in [d/2, d],
+// d = min(MQTT_BACKOFF_CAP_MS, MQTT_BACKOFF_BASE_MS * 2^n), seeded per device
+#define MQTT_BACKOFF_BASE_MS 2000
+#define MQTT_BACKOFF_CAP_MS 120000
+
+// device/status goes out on (re)connect, on a new IP or an RSSI at least
+// STATUS_RSSI_BUCKET_DB away from the last published one (at most every
+// STATUS_MIN_INTERVAL_MS) and every STATUS_KEEPALIVE_SEC otherwise
+#define STATUS_KEEPALIVE_SEC 300
+#define STATUS_MIN_INTERVAL_MS 5000
+#define STATUS_RSSI_BUCKET_DB 10
+
+// Loop latency histograms are always at /metrics,
+// > 0: also published to METRICS_TOPIC every N seconds
+#define METRICS_PUBLISH_SEC 0
+
+// Largest free heap block (bytes) below which TLS is reconnected to get fresh
+// BearSSL buffers, and below which the ESP restarts if that did not help (0 = off).
+// Checked while connected (TLS buffers allocated), so with or without MFLN it is
+// the room left for MQTT (1 KB), HTTP/SSE chunks (TCP_MSS), LittleFS and JSON,
+// about 4 KB together. Without MFLN a reconnect also needs ~17 KB in one block.
+#define HEAP_RECONNECT_BLOCK 8192
+#define HEAP_RESTART_BLOCK 6144
+
 // Settings
 const char *DEFAULT_USER = "admin";
 const char *DEFAULT_PASS = "123456";
@@ -13,6 +82,8 @@ const char *WIFI_HOSTNAME = "ClientESP8266";
 
 const uint8_t MQTT_QOS = 1;
 const bool MQTT_RETAIN = true;
+// PubSubClient packet buffer (default 256 is too small for batch frames)
+const uint16_t MQTT_BUFFER_SIZE = 1024;
 
 // Statuses
 const char OFFLINE_STATUS[] PROGMEM = "offline";
@@ -27,15 +98,34 @@ const char STATUS_JSON[] PROGMEM = R"({"status":"%s","ip":"%s","rssi":%d,"uptime
 const char MSG_JSON_ERROR[] PROGMEM = "⚠️ JSON error: %s";
 const char MSG_DEVICE_ID[] PROGMEM = "device_id: %s (local: %s)";
 const char MSG_MQTT_CMD[] PROGMEM = "📥 MQTT cmd: %s → %s";
-const char MSG_UNKNOWN_CMD[] PROGMEM = "⚠️ Unknown command: %s";
 
-// Topics for MQTT
+// MQTT topic layout
+// true: the shared flat topics below, as before; every device gets every
+//       command and keeps the ones whose "receiver" is its client id
+// false: per-device topics "<MQTT_TOPIC_PREFIX>/<name>" ({id} = client id):
+//        xy/<client_id>/cmd, .../cmd/reply, .../status, .../data, ...
+//        commands are only delivered to the device they are for;
+//        subscribers of the flat topics have to move to these
+#define MQTT_FLAT_TOPICS true
+#define MQTT_TOPIC_PREFIX "xy/{id}"
+// extra command topic for a group of devices or the whole fleet, "" = none
+// (e.g. "xy/all/cmd"); its results go to the device's own reply topic
+#define MQTT_GROUP_TOPIC ""
+
+// Flat topics for MQTT (MQTT_FLAT_TOPICS true)
 const char STATUS_TOPIC[] PROGMEM = "device/status";
+const char BOOT_TOPIC[] PROGMEM = "device/boot";
+const char METRICS_TOPIC[] PROGMEM = "device/metrics";
+const char STATUS_BIN_TOPIC[] PROGMEM = "device/status/bin"; // + "/<client_id>"
 const char COMMAND_TOPIC[] PROGMEM = "device/command";
+const char COMMAND_REPLY_TOPIC[] PROGMEM = "device/command/reply";
 // MQTT Topics for XY-L30A/XY-L10A
 const char TOPIC_XY_DATA[] PROGMEM = "esp/data";
+const char TOPIC_XY_DATA_BATCH[] PROGMEM = "esp/data/batch";
+const char TOPIC_XY_DATA_BIN[] PROGMEM = "esp/data/bin"; // + "/<client_id>"
 const char TOPIC_XY_CONFIG[] PROGMEM = "esp/config";
 const char TOPIC_XY_RAW[] PROGMEM = "esp/raw";
+const char TOPIC_XY_REPLY[] PROGMEM = "esp/reply";
 
 // Root certificate IRG_Root_X1
 const char IRG_Root_X1[] PROGMEM = R"CERT(
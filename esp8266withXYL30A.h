@@ -1,8 +1,50 @@
 #ifndef ESP8266_WITH_XY_L30A_H
 #define ESP8266_WITH_XY_L30A_H
 
-void loraReader();
-void handleXYResponse(const char *line);
+#include <time.h>
+#include "MqttTopics.h"
+#include "HeartbeatPolicy.h"
+
+// Boot phase durations, published once on the first MQTT connect
+struct BootTiming
+{
+  unsigned long eepromMs;
+  unsigned long wifiMs;
+  unsigned long tlsMs;
+  unsigned long mqttMs;
+  unsigned long readyMs; // millis() at the first MQTT connect
+  bool fastJoin;         // joined from the cached BSSID/channel
+  bool published;
+};
+
+// MQTT TLS handshakes, reported in device/status
+struct TlsStats
+{
+  uint16_t handshakes;
+  uint16_t resumed;     // handshakes that reused the cached session
+  unsigned long lastMs; // duration of the last handshake
+  bool lastResumed;
+  uint16_t mfln; // negotiated fragment length, 0 = full buffers
+};
+
+struct XYCommand;
+struct XYPacket;
+struct XYChannel;
+struct PublishPolicyConfig;
+
+void setupChannels();
+XYChannel *findChannel(const char *unit);
+const char *unitTopic(MqttTopic topic, const XYChannel &ch, char *buf, size_t size);
+void loraReader(XYChannel &ch);
+void handleXYResponse(XYChannel &ch, const char *line);
+void onXYCommandComplete(const XYChannel &ch, const XYCommand &cmd);
+void publishXYPacket(XYChannel &ch, const XYPacket &packet);
+size_t buildXYPacketJson(const XYPacket &packet, time_t ts, const char *unit, char *out, size_t size);
+void drainOutbox();
+void flushTelemetryBatch(XYChannel &ch);
+void publishBinary(const char *topic, const uint8_t *payload, size_t len);
+void buildMqttTopics();
+void applyPublishPolicy(const PublishPolicyConfig &cfg);
 void callback(char *topic, byte *payload, unsigned int length);
 void connectMQTT(bool force);
 void loadConfigFromEEPROM();
@@ -14,11 +56,23 @@ void saveConfigToEEPROM(const char *mqtt_ip, const char *mqtt_port,
 void loadAuthFromEEPROM();
 
 void connectToAP(const char *ssid, const char *pass, bool isCheckAttempt);
+bool fastJoin(const char *ssid, const char *pass);
+void cacheWiFiJoin();
+void publishBootTiming();
+void setupTls();
+bool connectTls();
+
+void setupTasks();
+void wifiTask();
+void mqttTask();
+void mqttConnectTask();
+void statusTask();
+void heapTask();
 
 void blink(int _delay, int num);
 void resetWiFiCredentials();
-void handleMQTTCommand(const char *action, const char *value);
-void publishStatus();
+void publishStatus(HeartbeatReason reason);
+void publishMetrics();
 
 void debugHeap(const char *topic);
 
@@ -0,0 +1,92 @@
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+// Minimal test runner for the host build: TEST() registers a case,
+// CHECK*() record failures and keep going, main() runs every case.
+// No dependencies, so the harness builds wherever a C++17 compiler does.
+
+#include <stdio.h>
+#include <string.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace hosttest
+{
+    struct Case
+    {
+        const char *name;
+        std::function<void()> run;
+    };
+
+    inline std::vector<Case> &cases()
+    {
+        static std::vector<Case> all;
+        return all;
+    }
+    inline int failures = 0;
+
+    struct Registrar
+    {
+        Registrar(const char *name, std::function<void()> run) { cases().push_back({name, run}); }
+    };
+
+    inline void fail(const char *file, int line, const std::string &what)
+    {
+        failures++;
+        fprintf(stderr, "%s:%d: FAILED %s\n", file, line, what.c_str());
+    }
+
+    inline std::string show(const std::string &v) { return "\"" + v + "\""; }
+    inline std::string show(const char *v) { return v ? show(std::string(v)) : "nullptr"; }
+    inline std::string show(char *v) { return show((const char *)v); }
+    inline std::string show(bool v) { return v ? "true" : "false"; }
+    template <typename T>
+    std::string show(const T &v) { return std::to_string(v); }
+
+    template <typename A, typename B>
+    bool equal(const A &a, const B &b) { return a == b; }
+    inline bool equal(const char *a, const char *b) { return a && b ? strcmp(a, b) == 0 : a == b; }
+    inline bool equal(char *a, const char *b) { return equal((const char *)a, b); }
+    inline bool equal(const std::string &a, const char *b) { return b && a == b; }
+}
+
+#define HOST_TEST_CONCAT2(a, b) a##b
+#define HOST_TEST_CONCAT(a, b) HOST_TEST_CONCAT2(a, b)
+
+#define TEST(name)                                                                                      \
+    static void name();                                                                                 \
+    static hosttest::Registrar HOST_TEST_CONCAT(registrar_, name)(#name, name);                         \
+    static void name()
+
+#define CHECK(cond)                                             \
+    do                                                          \
+    {                                                           \
+        if (!(cond))                                            \
+            hosttest::fail(__FILE__, __LINE__, "CHECK(" #cond ")"); \
+    } while (0)
+
+#define CHECK_EQ(a, b)                                                                                          \
+    do                                                                                                          \
+    {                                                                                                           \
+        auto &&hostA = (a);                                                                                     \
+        auto &&hostB = (b);                                                                                     \
+        if (!hosttest::equal(hostA, hostB))                                                                     \
+            hosttest::fail(__FILE__, __LINE__,                                                                  \
+                           "CHECK_EQ(" #a ", " #b "): " + hosttest::show(hostA) + " != " + hosttest::show(hostB)); \
+    } while (0)
+
+// defines main(), once per test executable
+#define HOST_TEST_MAIN()                                                    \
+    int main()                                                              \
+    {                                                                       \
+        for (const hosttest::Case &c : hosttest::cases())                   \
+        {                                                                   \
+            int before = hosttest::failures;                                \
+            c.run();                                                        \
+            printf("%s %s\n", hosttest::failures == before ? "ok  " : "FAIL", c.name); \
+        }                                                                   \
+        return hosttest::failures ? 1 : 0;                                  \
+    }
+
+#endif // HOST_TEST_H
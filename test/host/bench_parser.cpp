@@ -0,0 +1,229 @@
+// XYParser benchmark: the single-pass fixed-point decode() and classify()
+// against the strtok/atof parse() they replaced, over the trace rows of
+// the simulator scripts and lines captured from the simulator (clean and
+// noisy). Reports ns/line, lines/s and MB/s; exits non-zero if the two
+// parsers disagree on a line both accept or a threshold is missed:
+//   --min-speedup X    decode must be X times faster than the old parse
+//                      (machine independent, the ctest gate)
+//   --max-decode-ns N  decode must stay under N ns/line (for one machine)
+//
+// usage: bench_parser <scripts dir> [--rounds N] [--min-speedup X] [--max-decode-ns N]
+
+#include <Arduino.h>
+#include <dirent.h>
+#include <math.h>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "XYParser.h"
+#include "XYSimulator.h"
+#include "XYUartIngest.h"
+
+namespace
+{
+    // the parser before the fixed-point decode, kept as the baseline
+    struct LegacyPacket
+    {
+        float voltage;
+        int percent;
+        int hours;
+        int minutes;
+        char state[3];
+    };
+
+    bool legacyParse(const char *line, LegacyPacket &packet)
+    {
+        char buffer[64];
+        strncpy(buffer, line, sizeof(buffer));
+        buffer[sizeof(buffer) - 1] = '\0';
+
+        const char *delimiters = " ,:%";
+        char *token = strtok(buffer, delimiters);
+        int field = 0;
+
+        while (token != nullptr)
+        {
+            switch (field)
+            {
+            case 0:
+                packet.voltage = atof(token);
+                break;
+            case 1:
+                packet.percent = atoi(token);
+                break;
+            case 2:
+                packet.hours = atoi(token);
+                break;
+            case 3:
+                packet.minutes = atoi(token);
+                break;
+            case 4:
+                strncpy(packet.state, token, 2);
+                packet.state[2] = '\0';
+                break;
+            default:
+                return false;
+            }
+            token = strtok(nullptr, delimiters);
+            field++;
+        }
+
+        return (field == 5);
+    }
+
+    // "<delay_ms> <line>" rows of every *.sim script
+    void loadScripts(const std::string &dir, std::vector<std::string> &lines)
+    {
+        DIR *d = opendir(dir.c_str());
+        if (!d)
+            return;
+        while (dirent *entry = readdir(d))
+        {
+            std::string name = entry->d_name;
+            if (name.size() < 4 || name.compare(name.size() - 4, 4, ".sim") != 0)
+                continue;
+            std::ifstream in(dir + "/" + name);
+            std::string row;
+            while (std::getline(in, row))
+            {
+                size_t space = row.find(' ');
+                if (row.empty() || !isdigit((uint8_t)row[0]) || space == std::string::npos)
+                    continue;
+                lines.push_back(row.substr(space + 1));
+            }
+        }
+        closedir(d);
+    }
+
+    // lines as the ingest hands them out, noise per mille
+    void capture(uint16_t noise, uint32_t seed, size_t count, std::vector<std::string> &lines)
+    {
+        XYSimulator simulator;
+        simulator.begin(1000, 600);
+        simulator.setNoise(noise, seed);
+        XYUartIngest ingest;
+        ingest.begin(&simulator);
+
+        simulator.write((const uint8_t *)"read", 4);
+        char line[XYUartIngest::LINE_SIZE];
+        for (size_t n = 0; n < count;)
+        {
+            host::advanceMillis(1000);
+            ingest.pump();
+            while (n < count && ingest.readLine(line, sizeof(line)))
+            {
+                lines.push_back(line);
+                n++;
+            }
+        }
+    }
+
+    template <typename F>
+    double nsPerLine(const std::vector<std::string> &lines, unsigned rounds, F &&parse)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned r = 0; r < rounds; r++)
+        {
+            for (const std::string &line : lines)
+                parse(line.c_str());
+        }
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        return (double)ns / ((double)rounds * lines.size());
+    }
+
+    // keeps the optimizer from dropping the parse calls
+    volatile uint32_t sink;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <scripts dir> [--rounds N] [--min-speedup X] [--max-decode-ns N]\n", argv[0]);
+        return 2;
+    }
+    unsigned rounds = 200;
+    double minSpeedup = 0;
+    double maxDecodeNs = 0;
+    for (int i = 2; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--rounds") == 0)
+            rounds = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--min-speedup") == 0)
+            minSpeedup = atof(argv[i + 1]);
+        else if (strcmp(argv[i], "--max-decode-ns") == 0)
+            maxDecodeNs = atof(argv[i + 1]);
+    }
+
+    std::vector<std::string> lines;
+    loadScripts(argv[1], lines);
+    size_t traceLines = lines.size();
+    capture(0, 1, 2000, lines);
+    capture(100, 7, 2000, lines);
+
+    size_t bytes = 0;
+    for (const std::string &line : lines)
+        bytes += line.size();
+
+    // both parsers must agree on every line both accept
+    uint32_t both = 0;
+    uint32_t mismatches = 0;
+    uint32_t rejectedOnlyByDecode = 0;
+    for (const std::string &line : lines)
+    {
+        LegacyPacket legacy = {};
+        XYPacket packet = {};
+        bool legacyOk = legacyParse(line.c_str(), legacy);
+        bool decodeOk = XYParser::decode(line.c_str(), packet) == XY_PARSE_OK;
+        if (legacyOk && !decodeOk)
+            rejectedOnlyByDecode++;
+        if (!legacyOk || !decodeOk)
+            continue;
+        both++;
+        if (fabsf(legacy.voltage * 100 - packet.centivolts) > 0.5f || legacy.percent != packet.percent ||
+            legacy.hours != packet.hours || legacy.minutes != packet.minutes || strcmp(legacy.state, packet.state) != 0)
+        {
+            mismatches++;
+            fprintf(stderr, "mismatch: \"%s\"\n", line.c_str());
+        }
+    }
+
+    double legacyNs = nsPerLine(lines, rounds, [](const char *line)
+                                {
+                                    LegacyPacket packet;
+                                    sink = legacyParse(line, packet); });
+    double decodeNs = nsPerLine(lines, rounds, [](const char *line)
+                                {
+                                    XYPacket packet;
+                                    sink = XYParser::decode(line, packet); });
+    double classifyNs = nsPerLine(lines, rounds, [](const char *line)
+                                  {
+                                      XYFrame frame;
+                                      sink = XYParser::classify(line, frame); });
+
+    double avgBytes = (double)bytes / lines.size();
+    printf("corpus: %zu lines (%zu trace, %zu simulated), %.1f bytes/line, %u rounds\n",
+           lines.size(), traceLines, lines.size() - traceLines, avgBytes, rounds);
+    printf("%-16s %10s %12s %10s\n", "parser", "ns/line", "lines/s", "MB/s");
+    printf("%-16s %10.1f %12.0f %10.1f\n", "legacy parse", legacyNs, 1e9 / legacyNs, avgBytes * 1e3 / legacyNs);
+    printf("%-16s %10.1f %12.0f %10.1f\n", "decode", decodeNs, 1e9 / decodeNs, avgBytes * 1e3 / decodeNs);
+    printf("%-16s %10.1f %12.0f %10.1f\n", "classify", classifyNs, 1e9 / classifyNs, avgBytes * 1e3 / classifyNs);
+    printf("decode speedup: %.2fx\n", legacyNs / decodeNs);
+    printf("agreement: %u lines accepted by both, %u mismatches, %u accepted only by legacy parse\n",
+           both, mismatches, rejectedOnlyByDecode);
+
+    bool slow = false;
+    if (minSpeedup > 0 && legacyNs / decodeNs < minSpeedup)
+    {
+        fprintf(stderr, "decode speedup %.2fx is under --min-speedup %.2f\n", legacyNs / decodeNs, minSpeedup);
+        slow = true;
+    }
+    if (maxDecodeNs > 0 && decodeNs > maxDecodeNs)
+    {
+        fprintf(stderr, "decode %.1f ns/line is over --max-decode-ns %.1f\n", decodeNs, maxDecodeNs);
+        slow = true;
+    }
+
+    return mismatches || slow ? 1 : 0;
+}
@@ -0,0 +1,245 @@
+// Fuzz target for the UART line decoders: raw bytes go through
+// XYUartIngest line framing, then XYParser::decode and classify, and
+// the decoded fields are checked against what a valid frame can hold.
+// Built with ASan/UBSan, so out-of-bounds reads and overflows abort.
+//
+// With clang, -DHOST_LIBFUZZER=ON links it against libFuzzer
+// (coverage-guided). Otherwise the main() below is a seeded mutation
+// driver: script trace rows and typical lines are mutated with bit flips,
+// cuts, inserts, splices and over-long repeats.
+//
+// usage (driver): fuzz_decoders <scripts dir> [iterations] [seed]
+
+#include <Arduino.h>
+#include <dirent.h>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "XYParser.h"
+#include "XYUartIngest.h"
+
+namespace
+{
+    // byte source for the ingest
+    class FuzzPort : public Stream
+    {
+    public:
+        std::string bytes;
+        size_t pos = 0;
+
+        int available() override { return (int)(bytes.size() - pos); }
+        int read() override { return pos < bytes.size() ? (uint8_t)bytes[pos++] : -1; }
+        int peek() override { return pos < bytes.size() ? (uint8_t)bytes[pos] : -1; }
+        size_t write(uint8_t) override { return 1; }
+        using Print::write;
+    };
+
+    void require(bool ok, const char *what, const char *line)
+    {
+        if (ok)
+            return;
+        fprintf(stderr, "invariant failed: %s on \"%s\"\n", what, line);
+        abort();
+    }
+
+    void checkPacket(const XYPacket &packet, const char *line)
+    {
+        require(packet.percent >= 0 && packet.percent <= 100, "percent 0..100", line);
+        require(packet.hours >= 0 && packet.hours <= 99, "hours 0..99", line);
+        require(packet.minutes >= 0 && packet.minutes <= 59, "minutes 0..59", line);
+        size_t stateLen = strnlen(packet.state, sizeof(packet.state));
+        require(stateLen > 0 && stateLen < sizeof(packet.state), "state terminated", line);
+        for (size_t i = 0; i < stateLen; i++)
+            require(packet.state[i] >= 'A' && packet.state[i] <= 'Z', "state letters", line);
+    }
+
+    void decodeLine(const char *line)
+    {
+        XYPacket packet;
+        memset(&packet, 0xA5, sizeof(packet));
+        XYParseResult result = XYParser::decode(line, packet);
+        require(result <= XY_PARSE_ERR_TRAILING, "result in range", line);
+        require(packet.error == result, "error recorded", line);
+        require(XYParser::errorName(result) != nullptr, "error named", line);
+        if (result == XY_PARSE_OK)
+            checkPacket(packet, line);
+
+        XYFrame frame;
+        memset(&frame, 0xA5, sizeof(frame));
+        XYFrameType type = XYParser::classify(line, frame);
+        require(type == frame.type && type <= XY_FRAME_CONFIG, "frame type", line);
+        if (type == XY_FRAME_DATA)
+        {
+            checkPacket(frame.packet, line);
+        }
+        else if (type == XY_FRAME_CONFIG)
+        {
+            require(frame.config.mask != 0 && frame.config.mask < (1 << XY_KEY_COUNT), "config mask", line);
+            for (uint8_t key = 0; key < XY_KEY_COUNT; key++)
+            {
+                if (frame.config.mask & (1 << key))
+                    require(strnlen(frame.config.values[key], sizeof(frame.config.values[key])) <
+                                sizeof(frame.config.values[key]),
+                            "config value terminated", line);
+            }
+        }
+
+        char voltage[8];
+        size_t len = XYParser::formatVoltage(packet.centivolts, voltage, sizeof(voltage));
+        require(len < sizeof(voltage) && strlen(voltage) == len, "formatVoltage fits", line);
+    }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    // the decoders read C strings: the input as one line, NUL-terminated
+    std::string line((const char *)data, size);
+    decodeLine(line.c_str());
+
+    // and as UART bytes, framed by the ingest (state carries over, as on the wire)
+    static FuzzPort port;
+    static XYUartIngest ingest;
+    static bool started = false;
+    if (!started)
+    {
+        ingest.begin(&port);
+        started = true;
+    }
+
+    char out[XYUartIngest::LINE_SIZE];
+    for (size_t offset = 0; offset < size; offset += XYUartIngest::RING_SIZE / 2)
+    {
+        port.bytes.assign((const char *)data + offset, std::min(size - offset, (size_t)XYUartIngest::RING_SIZE / 2));
+        port.pos = 0;
+        ingest.pump();
+        size_t len;
+        while ((len = ingest.readLine(out, sizeof(out))) > 0)
+        {
+            require(len < sizeof(out) && strlen(out) == len, "line length", out);
+            for (size_t i = 0; i < len; i++)
+                require(out[i] >= 0x20 && out[i] <= 0x7E, "printable line", out);
+            decodeLine(out);
+        }
+    }
+    return 0;
+}
+
+#ifndef HOST_LIBFUZZER
+namespace
+{
+    uint32_t rng = 1;
+
+    // xorshift32, 0..range-1
+    uint32_t random(uint32_t range)
+    {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        return range ? rng % range : 0;
+    }
+
+    void loadSeeds(const char *dir, std::vector<std::string> &seeds)
+    {
+        static const char *const builtIn[] = {
+            "12.5V,100%,00:00,CL\r\n", "4.9V,005%,12:34,OP\r\n", "dw10.0,up12.5,00:00\r\n",
+            "th1.0,st0.5,et0.5\r\n", "DOWN\r\n", "FAIL\r\n", "655.35V,100%,99:59,OP\r\n", "00:01\r\n",
+        };
+        for (const char *seed : builtIn)
+            seeds.push_back(seed);
+
+        DIR *d = opendir(dir);
+        if (!d)
+            return;
+        while (dirent *entry = readdir(d))
+        {
+            std::string name = entry->d_name;
+            if (name.size() < 4 || name.compare(name.size() - 4, 4, ".sim") != 0)
+                continue;
+            std::ifstream in(std::string(dir) + "/" + name);
+            std::string row;
+            while (std::getline(in, row))
+            {
+                size_t space = row.find(' ');
+                if (!row.empty() && isdigit((uint8_t)row[0]) && space != std::string::npos)
+                    seeds.push_back(row.substr(space + 1) + "\r\n");
+            }
+        }
+        closedir(d);
+    }
+
+    std::string mutate(const std::vector<std::string> &seeds)
+    {
+        std::string s = seeds[random(seeds.size())];
+        uint32_t edits = 1 + random(4);
+        for (uint32_t e = 0; e < edits; e++)
+        {
+            switch (random(7))
+            {
+            case 0: // bit flip
+                if (!s.empty())
+                    s[random(s.size())] ^= 1 << random(8);
+                break;
+            case 1: // cut
+                s.resize(random(s.size() + 1));
+                break;
+            case 2: // random byte inserted
+                s.insert(s.begin() + random(s.size() + 1), (char)random(256));
+                break;
+            case 3: // byte deleted
+                if (!s.empty())
+                    s.erase(random(s.size()), 1);
+                break;
+            case 4: // spliced with another seed
+            {
+                const std::string &other = seeds[random(seeds.size())];
+                s += other.substr(random(other.size() + 1));
+                break;
+            }
+            case 5: // repeated past the line buffer
+                for (size_t len = s.size(); len && s.size() < 3 * XYUartIngest::LINE_SIZE;)
+                    s += s.substr(0, len);
+                break;
+            default: // digit or delimiter replaced
+                if (!s.empty())
+                    s[random(s.size())] = "0123456789.,:%V \r\n"[random(18)];
+                break;
+            }
+        }
+        return s;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <scripts dir> [iterations] [seed]\n", argv[0]);
+        return 2;
+    }
+    unsigned long iterations = argc > 2 ? strtoul(argv[2], nullptr, 10) : 200000;
+    rng = argc > 3 ? strtoul(argv[3], nullptr, 10) : 1;
+    if (!rng)
+        rng = 1;
+
+    std::vector<std::string> seeds;
+    loadSeeds(argv[1], seeds);
+
+    for (const std::string &seed : seeds)
+        LLVMFuzzerTestOneInput((const uint8_t *)seed.data(), seed.size());
+
+    uint32_t data = 0;
+    for (unsigned long i = 0; i < iterations; i++)
+    {
+        std::string input = mutate(seeds);
+        LLVMFuzzerTestOneInput((const uint8_t *)input.data(), input.size());
+
+        XYPacket packet;
+        if (XYParser::decode(input.c_str(), packet) == XY_PARSE_OK)
+            data++;
+    }
+
+    printf("%lu inputs from %zu seeds, %u decoded as data, no invariant failed\n",
+           iterations, seeds.size(), data);
+    return 0;
+}
+#endif
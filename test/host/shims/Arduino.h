@@ -0,0 +1,371 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// Host stand-in for the parts of the ESP8266 Arduino core the firmware
+// modules use: PROGMEM helpers, a manual clock, String, Print/Stream,
+// Serial and ESP. Only what the modules need, no hardware behaviour.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <ctype.h>
+#include <time.h>
+#include <algorithm>
+#include <functional>
+#include <string>
+
+// PROGMEM is plain memory on the host; "%S" (PROGMEM string argument) is
+// turned into "%s" by the *_P formatters below
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(s) (s)
+#define F(s) (s)
+#define FPSTR(s) (s)
+#define IRAM_ATTR
+#define ICACHE_RAM_ATTR
+#define strlen_P strlen
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+#define strcmp_P strcmp
+#define strncmp_P strncmp
+#define strcasecmp_P strcasecmp
+#define memcpy_P memcpy
+#define memcmp_P memcmp
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(const uint16_t *)(p))
+#define pgm_read_dword(p) (*(const uint32_t *)(p))
+#define pgm_read_ptr(p) (*(void *const *)(p))
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+using std::max;
+using std::min;
+
+#define constrain(x, low, high) ((x) < (low) ? (low) : ((x) > (high) ? (high) : (x)))
+
+namespace host
+{
+    // the clock only moves when a test moves it
+    inline uint64_t clockUs = 0;
+
+    inline void setMillis(unsigned long ms) { clockUs = (uint64_t)ms * 1000; }
+    inline void advanceMillis(unsigned long ms) { clockUs += (uint64_t)ms * 1000; }
+    inline void advanceMicros(unsigned long us) { clockUs += us; }
+
+    inline std::string pgmFormat(const char *fmt)
+    {
+        std::string out(fmt);
+        for (size_t i = 0; i + 1 < out.size(); i++)
+        {
+            if (out[i] != '%')
+                continue;
+            if (out[i + 1] == '%')
+                i++;
+            else if (out[i + 1] == 'S')
+                out[i + 1] = 's';
+        }
+        return out;
+    }
+}
+
+namespace host
+{
+    // time(): seconds since boot until a test "syncs NTP" by setting the
+    // unix time of boot, as on the device before the first NTP answer
+    inline time_t unixTimeAtBoot = 0;
+
+    inline time_t unixTime(time_t *out)
+    {
+        time_t now = unixTimeAtBoot + (time_t)(clockUs / 1000000);
+        if (out)
+            *out = now;
+        return now;
+    }
+}
+#define time(out) host::unixTime(out)
+
+inline unsigned long millis() { return (unsigned long)(host::clockUs / 1000); }
+inline unsigned long micros() { return (unsigned long)host::clockUs; }
+inline void delay(unsigned long ms) { host::advanceMillis(ms); }
+inline void yield() {}
+inline bool isAscii(int c) { return (c & ~0x7f) == 0; }
+
+inline int vsnprintf_P(char *out, size_t size, const char *fmt, va_list args)
+{
+    std::string f = host::pgmFormat(fmt);
+    return vsnprintf(out, size, f.c_str(), args);
+}
+
+inline int snprintf_P(char *out, size_t size, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf_P(out, size, fmt, args);
+    va_end(args);
+    return len;
+}
+
+inline int sprintf_P(char *out, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf_P(out, 4096, fmt, args);
+    va_end(args);
+    return len;
+}
+
+#ifndef __GLIBC__
+inline size_t strlcpy(char *dst, const char *src, size_t size)
+{
+    size_t len = strlen(src);
+    if (size)
+    {
+        size_t n = len < size - 1 ? len : size - 1;
+        memcpy(dst, src, n);
+        dst[n] = '\0';
+    }
+    return len;
+}
+#else
+inline size_t hostStrlcpy(char *dst, const char *src, size_t size)
+{
+    size_t len = strlen(src);
+    if (size)
+    {
+        size_t n = len < size - 1 ? len : size - 1;
+        memcpy(dst, src, n);
+        dst[n] = '\0';
+    }
+    return len;
+}
+#define strlcpy hostStrlcpy
+#endif
+
+// GPIO, recorded for tests
+#define LED_BUILTIN 2
+#define INPUT 0
+#define OUTPUT 1
+#define LOW 0
+#define HIGH 1
+
+namespace host
+{
+    inline uint8_t pinModes[17] = {};
+    inline uint8_t pinLevels[17] = {};
+}
+
+inline void pinMode(uint8_t pin, uint8_t mode)
+{
+    if (pin < 17)
+        host::pinModes[pin] = mode;
+}
+inline void digitalWrite(uint8_t pin, uint8_t level)
+{
+    if (pin < 17)
+        host::pinLevels[pin] = level;
+}
+inline int digitalRead(uint8_t pin) { return pin < 17 ? host::pinLevels[pin] : LOW; }
+
+class String
+{
+public:
+    String() {}
+    String(const char *s) : s(s ? s : "") {}
+    String(const std::string &s) : s(s) {}
+    String(char c) : s(1, c) {}
+    String(int v) : s(std::to_string(v)) {}
+    String(unsigned v) : s(std::to_string(v)) {}
+    String(long v) : s(std::to_string(v)) {}
+    String(unsigned long v) : s(std::to_string(v)) {}
+
+    const char *c_str() const { return s.c_str(); }
+    unsigned int length() const { return s.size(); }
+    bool isEmpty() const { return s.empty(); }
+    long toInt() const { return strtol(s.c_str(), nullptr, 10); }
+    bool equals(const String &o) const { return s == o.s; }
+    bool startsWith(const String &o) const { return s.compare(0, o.s.size(), o.s) == 0; }
+    int indexOf(char c) const
+    {
+        size_t i = s.find(c);
+        return i == std::string::npos ? -1 : (int)i;
+    }
+    String substring(unsigned from, unsigned to = ~0u) const
+    {
+        if (from > s.size())
+            return String();
+        return String(s.substr(from, to == ~0u ? std::string::npos : to - from));
+    }
+    char operator[](unsigned i) const { return i < s.size() ? s[i] : '\0'; }
+
+    String &operator+=(const String &o)
+    {
+        s += o.s;
+        return *this;
+    }
+    String &operator+=(const char *o)
+    {
+        s += o;
+        return *this;
+    }
+    String &operator+=(char c)
+    {
+        s += c;
+        return *this;
+    }
+    friend String operator+(const String &a, const String &b) { return String(a.s + b.s); }
+    friend String operator+(const String &a, const char *b) { return String(a.s + b); }
+
+    bool operator==(const String &o) const { return s == o.s; }
+    bool operator==(const char *o) const { return s == (o ? o : ""); }
+    bool operator!=(const String &o) const { return s != o.s; }
+    bool operator!=(const char *o) const { return !(*this == o); }
+
+private:
+    std::string s;
+};
+
+// result type of String concatenation in the core, ArduinoJson adapts both
+class StringSumHelper : public String
+{
+public:
+    using String::String;
+    StringSumHelper(const String &s) : String(s) {}
+};
+
+class Print
+{
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buf, size_t size)
+    {
+        size_t n = 0;
+        while (size--)
+            n += write(*buf++);
+        return n;
+    }
+    size_t write(const char *buf, size_t size) { return write((const uint8_t *)buf, size); }
+    size_t write(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+    virtual int availableForWrite() { return 0; }
+    virtual void flush() {}
+
+    size_t print(const char *s) { return write(s); }
+    size_t print(const String &s) { return write(s.c_str()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int v) { return printf("%d", v); }
+    size_t print(unsigned v) { return printf("%u", v); }
+    size_t print(long v) { return printf("%ld", v); }
+    size_t print(unsigned long v) { return printf("%lu", v); }
+    size_t println() { return print("\r\n"); }
+    template <typename T>
+    size_t println(const T &v) { return print(v) + println(); }
+
+    size_t printf(const char *fmt, ...) __attribute__((format(printf, 2, 3)))
+    {
+        va_list args;
+        va_start(args, fmt);
+        size_t n = vprintf(fmt, args);
+        va_end(args);
+        return n;
+    }
+    size_t printf_P(const char *fmt, ...)
+    {
+        va_list args;
+        va_start(args, fmt);
+        size_t n = vprintf(host::pgmFormat(fmt).c_str(), args);
+        va_end(args);
+        return n;
+    }
+
+private:
+    size_t vprintf(const char *fmt, va_list args)
+    {
+        char buf[512];
+        va_list copy;
+        va_copy(copy, args);
+        int len = vsnprintf(buf, sizeof(buf), fmt, copy);
+        va_end(copy);
+        if (len < 0)
+            return 0;
+        if ((size_t)len < sizeof(buf))
+            return write((const uint8_t *)buf, len);
+        std::string big(len + 1, '\0');
+        vsnprintf(&big[0], big.size(), fmt, args);
+        return write((const uint8_t *)big.data(), len);
+    }
+};
+
+class Stream : public Print
+{
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    using Print::write;
+
+    size_t readBytes(uint8_t *buf, size_t size)
+    {
+        size_t n = 0;
+        while (n < size && available() > 0)
+            buf[n++] = read();
+        return n;
+    }
+    size_t readBytes(char *buf, size_t size) { return readBytes((uint8_t *)buf, size); }
+};
+
+// Serial goes to stdout, so a failing test shows what the module logged
+class HardwareSerial : public Stream
+{
+public:
+    void begin(unsigned long) {}
+    void end() {}
+    void swap() {}
+    void setRxBufferSize(size_t) {}
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+    size_t write(uint8_t c) override { return fputc(c, stdout) == EOF ? 0 : 1; }
+    using Print::write;
+};
+
+inline HardwareSerial Serial;
+
+// ESP8266 SDK calls, values set by the tests
+class EspClass
+{
+public:
+    uint32_t chipId = 0x00C0FFEE;
+    uint32_t freeHeap = 40000;
+    uint32_t maxBlock = 20000;
+    uint8_t fragmentation = 10;
+    uint32_t freeContStack = 3000;
+    uint32_t restarts = 0;
+
+    uint32_t getChipId() const { return chipId; }
+    uint8_t getCpuFreqMHz() const { return 80; }
+    // 80 cycles per microsecond of the host clock
+    uint32_t getCycleCount() const { return (uint32_t)(host::clockUs * 80); }
+    uint32_t getFreeHeap() const { return freeHeap; }
+    uint32_t getMaxFreeBlockSize() const { return maxBlock; }
+    uint8_t getHeapFragmentation() const { return fragmentation; }
+    uint32_t getFreeContStack() const { return freeContStack; }
+    void getHeapStats(uint32_t *free, uint32_t *block, uint8_t *frag) const
+    {
+        if (free)
+            *free = freeHeap;
+        if (block)
+            *block = maxBlock;
+        if (frag)
+            *frag = fragmentation;
+    }
+    String getResetReason() const { return String("Power On"); }
+    void restart() { restarts++; }
+};
+
+inline EspClass ESP;
+
+#endif // HOST_ARDUINO_H
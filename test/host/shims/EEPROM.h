@@ -0,0 +1,93 @@
+#ifndef HOST_EEPROM_H
+#define HOST_EEPROM_H
+
+#include <Arduino.h>
+
+// Emulated EEPROM as in the ESP8266 core: a RAM copy of one flash sector,
+// commit() erases the sector and writes the whole copy back.
+// failNextCommit simulates a power cut: the sector is erased (0xFF), only
+// the first failedCommitBytes are written again and the commit fails.
+class EEPROMClass
+{
+public:
+    static const size_t SECTOR_SIZE = 4096;
+
+    uint8_t flash[SECTOR_SIZE];
+    uint32_t commits = 0;
+    bool failNextCommit = false;
+    size_t failedCommitBytes = 0;
+
+    EEPROMClass() { memset(flash, 0xFF, sizeof(flash)); }
+
+    void begin(size_t size)
+    {
+        _size = size < SECTOR_SIZE ? size : SECTOR_SIZE;
+        memcpy(data, flash, _size);
+    }
+    void end() {}
+
+    uint8_t read(int addr) const { return addr >= 0 && (size_t)addr < _size ? data[addr] : 0; }
+    void write(int addr, uint8_t value)
+    {
+        if (addr >= 0 && (size_t)addr < _size)
+        {
+            data[addr] = value;
+            dirty = true;
+        }
+    }
+
+    template <typename T>
+    T &get(int addr, T &t) const
+    {
+        memcpy(&t, data + addr, sizeof(T));
+        return t;
+    }
+    template <typename T>
+    const T &put(int addr, const T &t)
+    {
+        memcpy(data + addr, &t, sizeof(T));
+        dirty = true;
+        return t;
+    }
+
+    bool commit()
+    {
+        if (!dirty)
+            return true;
+        commits++;
+        memset(flash, 0xFF, sizeof(flash));
+        if (failNextCommit)
+        {
+            failNextCommit = false;
+            memcpy(flash, data, failedCommitBytes < _size ? failedCommitBytes : _size);
+            return false;
+        }
+        memcpy(flash, data, _size);
+        dirty = false;
+        return true;
+    }
+
+    const uint8_t *getConstDataPtr() const { return data; }
+    uint8_t *getDataPtr()
+    {
+        dirty = true;
+        return data;
+    }
+    size_t length() const { return _size; }
+
+    // reboot: the RAM copy is gone, begin() reads the flash again
+    void powerCycle()
+    {
+        memset(data, 0, sizeof(data));
+        _size = 0;
+    }
+
+private:
+    uint8_t data[SECTOR_SIZE] = {};
+    size_t _size = 0;
+    bool dirty = false;
+};
+
+inline EEPROMClass EEPROM;
+
+#endif // HOST_EEPROM_H
@@ -0,0 +1,202 @@
+#ifndef HOST_ESP8266_WEB_SERVER_H
+#define HOST_ESP8266_WEB_SERVER_H
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <initializer_list>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+enum HTTPMethod
+{
+    HTTP_ANY,
+    HTTP_GET,
+    HTTP_HEAD,
+    HTTP_POST,
+    HTTP_PUT,
+    HTTP_PATCH,
+    HTTP_DELETE,
+    HTTP_OPTIONS,
+};
+
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+#define CONTENT_LENGTH_NOT_SET ((size_t)-2)
+
+// ESP8266WebServer stand-in without sockets: request() runs the handler
+// of a route at once and returns what it sent.
+class ESP8266WebServer
+{
+public:
+    typedef std::function<void()> THandlerFunction;
+    typedef std::function<String(const String &)> ContentTypeFunction;
+    enum ClientFuture
+    {
+        CLIENT_REQUEST_CAN_CONTINUE,
+        CLIENT_REQUEST_IS_HANDLED,
+        CLIENT_MUST_STOP,
+        CLIENT_IS_GIVEN,
+    };
+    typedef std::function<ClientFuture(const String &method, const String &url, WiFiClient *client,
+                                       ContentTypeFunction contentType)>
+        HookFunction;
+
+    struct Response
+    {
+        int code = 0;
+        std::string contentType;
+        std::map<std::string, std::string> headers;
+        std::string body;
+        size_t contentLength = CONTENT_LENGTH_NOT_SET;
+        uint32_t contentWrites = 0; // sendContent() calls
+        size_t largestWrite = 0;
+    };
+
+    explicit ESP8266WebServer(int port = 80) : port(port) { last() = this; }
+    ~ESP8266WebServer()
+    {
+        if (last() == this)
+            last() = nullptr;
+    }
+
+    // the server constructed last, for modules that keep theirs private
+    static ESP8266WebServer *&last()
+    {
+        static ESP8266WebServer *server = nullptr;
+        return server;
+    }
+
+    void on(const char *uri, HTTPMethod method, THandlerFunction fn) { routes.push_back({uri, method, fn}); }
+    void onNotFound(THandlerFunction fn) { notFound = fn; }
+    void addHook(HookFunction hook) { hooks.push_back(hook); }
+    void collectHeaders(const char *keys[], size_t count)
+    {
+        for (size_t i = 0; i < count; i++)
+            collected.push_back(keys[i]);
+    }
+    void begin() { started = true; }
+    void handleClient() { handleClientCalls++; }
+
+    const String &arg(const String &name) const
+    {
+        static const String none;
+        auto it = args.find(name.c_str());
+        return it == args.end() ? none : it->second;
+    }
+    bool hasArg(const String &name) const { return args.count(name.c_str()) > 0; }
+    const String &header(const String &name) const
+    {
+        static const String none;
+        auto it = headers.find(name.c_str());
+        return it == headers.end() ? none : it->second;
+    }
+
+    bool authenticate(const char *user, const char *pass) const
+    {
+        return requestUser == user && requestPass == pass;
+    }
+    void requestAuthentication() { send(401); }
+
+    void setContentLength(size_t length) { pendingLength = length; }
+    void sendHeader(const String &name, const String &value, bool = false)
+    {
+        pendingHeaders[name.c_str()] = value.c_str();
+    }
+    void send(int code, const char *contentType = nullptr, const char *content = "")
+    {
+        response.code = code;
+        response.contentType = contentType ? contentType : "";
+        response.headers = pendingHeaders;
+        response.contentLength = pendingLength == CONTENT_LENGTH_NOT_SET ? strlen(content) : pendingLength;
+        response.body = content;
+    }
+    void send(int code, const char *contentType, const String &content) { send(code, contentType, content.c_str()); }
+    void send_P(int code, PGM_P contentType, PGM_P content, size_t length)
+    {
+        send(code, contentType, "");
+        response.contentLength = length;
+        response.body.assign(content, length);
+    }
+    void sendContent(const char *content, size_t length)
+    {
+        response.body.append(content, length);
+        response.contentWrites++;
+        response.largestWrite = std::max(response.largestWrite, length);
+    }
+    void sendContent(const String &content) { sendContent(content.c_str(), content.length()); }
+
+    WiFiClient client() { return connection; }
+
+    // test side
+    void setCredentials(const char *user, const char *pass)
+    {
+        requestUser = user;
+        requestPass = pass;
+    }
+
+    const Response &request(HTTPMethod method, const char *uri,
+                            std::initializer_list<std::pair<const char *, const char *>> query = {},
+                            std::initializer_list<std::pair<const char *, const char *>> requestHeaders = {})
+    {
+        args.clear();
+        headers.clear();
+        for (const auto &kv : query)
+            args[kv.first] = kv.second;
+        for (const auto &kv : requestHeaders)
+            headers[kv.first] = kv.second;
+        response = Response();
+        pendingHeaders.clear();
+        pendingLength = CONTENT_LENGTH_NOT_SET;
+        connection = WiFiClient::open();
+        requests++;
+
+        for (const HookFunction &hook : hooks)
+            hook(method == HTTP_POST ? "POST" : "GET", uri, &connection, nullptr);
+
+        for (const Route &route : routes)
+        {
+            if (route.uri == uri && (route.method == HTTP_ANY || route.method == method))
+            {
+                route.fn();
+                return response;
+            }
+        }
+        if (notFound)
+            notFound();
+        return response;
+    }
+
+    const Response &lastResponse() const { return response; }
+    WiFiClient &lastClient() { return connection; }
+
+    int port;
+    bool started = false;
+    uint32_t handleClientCalls = 0;
+    uint32_t requests = 0;
+
+private:
+    struct Route
+    {
+        std::string uri;
+        HTTPMethod method;
+        THandlerFunction fn;
+    };
+
+    std::vector<Route> routes;
+    THandlerFunction notFound;
+    std::vector<HookFunction> hooks;
+    std::vector<std::string> collected;
+
+    std::map<std::string, String> args;
+    std::map<std::string, String> headers;
+    std::string requestUser;
+    std::string requestPass;
+
+    std::map<std::string, std::string> pendingHeaders;
+    size_t pendingLength = CONTENT_LENGTH_NOT_SET;
+    Response response;
+    WiFiClient connection;
+};
+
+#endif // HOST_ESP8266_WEB_SERVER_H
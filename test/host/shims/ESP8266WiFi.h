@@ -0,0 +1,108 @@
+#ifndef HOST_ESP8266_WIFI_H
+#define HOST_ESP8266_WIFI_H
+
+#include <Arduino.h>
+#include <memory>
+#include <string>
+
+class IPAddress
+{
+public:
+    IPAddress() {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : addr((uint32_t)d << 24 | (uint32_t)c << 16 | b << 8 | a) {}
+    IPAddress(uint32_t address) : addr(address) {}
+
+    operator uint32_t() const { return addr; }
+    uint8_t operator[](int i) const { return addr >> (8 * i); }
+    String toString() const
+    {
+        char buf[16];
+        snprintf(buf, sizeof(buf), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+        return String(buf);
+    }
+
+private:
+    uint32_t addr = 0; // first octet in the low byte, as in the core
+};
+
+// A TCP connection; copies share it, as WiFiClient copies share their
+// ClientContext on the device. The test reads what was sent from out()
+// and limits the send buffer with setWindow().
+class WiFiClient : public Stream
+{
+public:
+    struct Connection
+    {
+        std::string out;
+        size_t window = 2 * 1460;
+        bool connected = true;
+        bool noDelay = false;
+    };
+
+    WiFiClient() {}
+    static WiFiClient open() { return WiFiClient(std::make_shared<Connection>()); }
+
+    uint8_t connected() { return conn && conn->connected; }
+    explicit operator bool() { return connected(); }
+    void stop()
+    {
+        if (conn)
+            conn->connected = false;
+    }
+    void setNoDelay(bool on)
+    {
+        if (conn)
+            conn->noDelay = on;
+    }
+
+    int availableForWrite() override { return connected() ? (int)conn->window : 0; }
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buf, size_t size) override
+    {
+        if (!connected())
+            return 0;
+        conn->out.append((const char *)buf, size);
+        return size;
+    }
+    using Print::write;
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+
+    // test access
+    std::string &out() { return conn->out; }
+    void setWindow(size_t bytes) { conn->window = bytes; }
+    void disconnect() { conn->connected = false; }
+    bool sameConnection(const WiFiClient &o) const { return conn == o.conn; }
+
+private:
+    std::shared_ptr<Connection> conn;
+
+    explicit WiFiClient(std::shared_ptr<Connection> c) : conn(c) {}
+};
+
+typedef enum
+{
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_DISCONNECTED = 6,
+} wl_status_t;
+
+// Station state, set by the tests
+class ESP8266WiFiClass
+{
+public:
+    wl_status_t state = WL_CONNECTED;
+    int32_t rssi = -60;
+    IPAddress ip = IPAddress(192, 168, 1, 50);
+
+    wl_status_t status() const { return state; }
+    int32_t RSSI() const { return rssi; }
+    IPAddress localIP() const { return ip; }
+};
+
+inline ESP8266WiFiClass WiFi;
+
+#endif // HOST_ESP8266_WIFI_H
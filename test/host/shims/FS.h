@@ -0,0 +1,165 @@
+#ifndef HOST_FS_H
+#define HOST_FS_H
+
+#include <Arduino.h>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+
+// In-memory file system with the LittleFS API the modules use.
+// Files survive as long as the FS object, so a test can "reboot" a module
+// by constructing it again against the same FS.
+namespace fs
+{
+    typedef std::map<std::string, std::string> FileMap;
+
+    class File : public Stream
+    {
+    public:
+        File() {}
+        File(std::shared_ptr<FileMap> files, const std::string &path, bool append)
+            : files(files), path(path), pos(append ? (*files)[path].size() : 0) {}
+
+        explicit operator bool() const { return (bool)files; }
+
+        int available() override { return files ? (int)(data().size() - pos) : 0; }
+        int read() override { return available() > 0 ? (uint8_t)data()[pos++] : -1; }
+        int peek() override { return available() > 0 ? (uint8_t)data()[pos] : -1; }
+        size_t write(uint8_t c) override { return write(&c, 1); }
+        size_t write(const uint8_t *buf, size_t size) override
+        {
+            if (!files)
+                return 0;
+            std::string &d = data();
+            if (pos > d.size())
+                d.resize(pos, '\0');
+            d.replace(pos, std::min(size, d.size() - pos), (const char *)buf, size);
+            pos += size;
+            return size;
+        }
+        using Print::write;
+
+        size_t readBytesUntil(char terminator, char *buf, size_t size)
+        {
+            size_t n = 0;
+            while (n < size && available() > 0)
+            {
+                char c = read();
+                if (c == terminator)
+                    break;
+                buf[n++] = c;
+            }
+            return n;
+        }
+
+        bool seek(size_t to)
+        {
+            if (!files || to > data().size())
+                return false;
+            pos = to;
+            return true;
+        }
+        size_t position() const { return pos; }
+        size_t size() const
+        {
+            if (!files)
+                return 0;
+            auto it = files->find(path);
+            return it == files->end() ? 0 : it->second.size();
+        }
+        void close() { files.reset(); }
+
+    private:
+        std::shared_ptr<FileMap> files;
+        std::string path;
+        size_t pos = 0;
+
+        std::string &data() { return (*files)[path]; }
+    };
+
+    class Dir
+    {
+    public:
+        Dir() {}
+        Dir(std::shared_ptr<FileMap> files, const std::string &dir) : files(files), prefix(dir + "/") {}
+
+        bool next()
+        {
+            if (!files)
+                return false;
+            auto it = started ? files->upper_bound(current) : files->lower_bound(prefix);
+            started = true;
+            for (; it != files->end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it)
+            {
+                if (it->first.find('/', prefix.size()) == std::string::npos)
+                {
+                    current = it->first;
+                    return true;
+                }
+            }
+            return false;
+        }
+        String fileName() const { return String(current.substr(prefix.size())); }
+        size_t fileSize() const { return files->at(current).size(); }
+
+    private:
+        std::shared_ptr<FileMap> files;
+        std::string prefix;
+        std::string current;
+        bool started = false;
+    };
+
+    class FS
+    {
+    public:
+        bool mounted = false;
+        bool failBegin = false; // simulates an unformatted/broken flash
+
+        bool begin()
+        {
+            mounted = !failBegin;
+            return mounted;
+        }
+        void end() { mounted = false; }
+
+        // mode "r", "w" or "a"
+        File open(const char *path, const char *mode)
+        {
+            if (!mounted)
+                return File();
+            if (mode[0] == 'r' && !files->count(path))
+                return File();
+            if (mode[0] == 'w')
+                (*files)[path].clear();
+            return File(files, path, mode[0] == 'a');
+        }
+        bool exists(const char *path) const { return files->count(path) || dirs.count(path); }
+        bool mkdir(const char *path)
+        {
+            dirs.insert(path);
+            return true;
+        }
+        bool remove(const char *path) { return files->erase(path) > 0; }
+        Dir openDir(const char *path) { return Dir(files, path); }
+
+        // test access
+        std::string &content(const char *path) { return (*files)[path]; }
+        size_t fileCount() const { return files->size(); }
+        void format()
+        {
+            files->clear();
+            dirs.clear();
+        }
+
+    private:
+        std::shared_ptr<FileMap> files = std::make_shared<FileMap>();
+        std::set<std::string> dirs;
+    };
+}
+
+using fs::Dir;
+using fs::File;
+using fs::FS;
+
+#endif // HOST_FS_H
@@ -0,0 +1,8 @@
+#ifndef HOST_LITTLEFS_H
+#define HOST_LITTLEFS_H
+
+#include <FS.h>
+
+inline fs::FS LittleFS;
+
+#endif // HOST_LITTLEFS_H
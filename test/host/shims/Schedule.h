@@ -0,0 +1,39 @@
+#ifndef HOST_SCHEDULE_H
+#define HOST_SCHEDULE_H
+
+#include <functional>
+#include <vector>
+
+// Recurrent functions run when a test calls host::runScheduled(),
+// the host's stand-in for the end of loop() / yield()
+namespace host
+{
+    inline std::vector<std::function<bool()>> scheduled;
+
+    inline void runScheduled()
+    {
+        for (size_t i = 0; i < scheduled.size();)
+        {
+            if (scheduled[i]())
+                i++;
+            else
+                scheduled.erase(scheduled.begin() + i);
+        }
+    }
+}
+
+inline bool schedule_recurrent_function_us(std::function<bool()> fn, uint32_t,
+                                           std::function<bool()> = nullptr)
+{
+    host::scheduled.push_back(fn);
+    return true;
+}
+
+inline bool schedule_function(std::function<void()> fn)
+{
+    host::scheduled.push_back([fn]()
+                              { fn(); return false; });
+    return true;
+}
+
+#endif // HOST_SCHEDULE_H
@@ -0,0 +1,51 @@
+#ifndef HOST_SOFTWARE_SERIAL_H
+#define HOST_SOFTWARE_SERIAL_H
+
+#include <Arduino.h>
+#include <string>
+
+enum SoftwareSerialConfig
+{
+    SWSERIAL_8N1 = 0,
+};
+
+// SoftwareSerial stand-in: the test feeds received bytes with inject()
+// and reads what the firmware sent from sent
+class SoftwareSerial : public Stream
+{
+public:
+    int8_t rxPin = -1;
+    int8_t txPin = -1;
+    unsigned long baud = 0;
+    std::string sent;
+
+    SoftwareSerial() {}
+    SoftwareSerial(int8_t rx, int8_t tx) : rxPin(rx), txPin(tx) {}
+
+    void begin(unsigned long rate) { baud = rate; }
+    void begin(unsigned long rate, SoftwareSerialConfig, int8_t rx, int8_t tx)
+    {
+        baud = rate;
+        rxPin = rx;
+        txPin = tx;
+    }
+
+    void inject(const char *bytes) { rx.append(bytes); }
+
+    int available() override { return (int)(rx.size() - rxPos); }
+    int read() override { return available() > 0 ? (uint8_t)rx[rxPos++] : -1; }
+    int peek() override { return available() > 0 ? (uint8_t)rx[rxPos] : -1; }
+    size_t write(uint8_t c) override
+    {
+        sent.push_back((char)c);
+        return 1;
+    }
+    using Print::write;
+    int availableForWrite() override { return 64; }
+
+private:
+    std::string rx;
+    size_t rxPos = 0;
+};
+
+#endif // HOST_SOFTWARE_SERIAL_H
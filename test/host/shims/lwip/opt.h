@@ -0,0 +1,7 @@
+#ifndef HOST_LWIP_OPT_H
+#define HOST_LWIP_OPT_H
+
+// lwIP2 "higher bandwidth" build of the ESP8266 core
+#define TCP_MSS 1460
+
+#endif // HOST_LWIP_OPT_H
@@ -0,0 +1,230 @@
+// Runs a simulator script through the UART path the firmware uses:
+// XYSimulator -> XYUartIngest -> XYParser::classify -> PublishPolicy /
+// XYCommandQueue, on the host clock in 10 ms steps.
+//
+// A script is an XYSimulator trace ("<delay_ms> <line>" rows, replayed
+// as-is) plus "#" directives the simulator skips:
+//   # model <interval_ms> <speedup>   without trace rows, the model runs
+//   # noise <per_mille> <seed>
+//   # policy <spec>                   PublishPolicy::parseConfig syntax
+//   # run <ms>                        how long to run
+//   # send <at_ms> <command>          enqueue a command at that time
+//   # expect <counter> <==|>=|<=> <value>
+//
+// usage: simulator_scripts <script>
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <Schedule.h>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include "PublishPolicy.h"
+#include "XYCommandQueue.h"
+#include "XYParser.h"
+#include "XYSimulator.h"
+#include "XYUartIngest.h"
+
+namespace
+{
+    const unsigned long STEP_MS = 10;
+    const char *const TRACE_PATH = "/trace.txt";
+
+    struct Send
+    {
+        unsigned long at;
+        std::string command;
+        bool done;
+    };
+
+    struct Expect
+    {
+        std::string counter;
+        std::string op;
+        long value;
+        int line;
+    };
+
+    struct Script
+    {
+        unsigned long interval = 1000;
+        uint16_t speedup = 1;
+        uint16_t noise = 0;
+        uint32_t seed = 1;
+        std::string policy;
+        unsigned long runMs = 10000;
+        std::vector<Send> sends;
+        std::vector<Expect> expects;
+        std::string text;
+    };
+
+    bool load(const char *path, Script &script)
+    {
+        std::ifstream in(path);
+        if (!in)
+            return false;
+
+        std::stringstream all;
+        all << in.rdbuf();
+        script.text = all.str();
+
+        std::istringstream lines(script.text);
+        std::string row;
+        int lineNo = 0;
+        while (std::getline(lines, row))
+        {
+            lineNo++;
+            if (row.compare(0, 2, "# ") != 0)
+                continue;
+            std::istringstream words(row.substr(2));
+            std::string directive;
+            words >> directive;
+            if (directive == "model")
+                words >> script.interval >> script.speedup;
+            else if (directive == "noise")
+                words >> script.noise >> script.seed;
+            else if (directive == "policy")
+                words >> script.policy;
+            else if (directive == "run")
+                words >> script.runMs;
+            else if (directive == "send")
+            {
+                Send send = {0, "", false};
+                words >> send.at >> send.command;
+                script.sends.push_back(send);
+            }
+            else if (directive == "expect")
+            {
+                Expect expect = {"", "", 0, lineNo};
+                words >> expect.counter >> expect.op >> expect.value;
+                script.expects.push_back(expect);
+            }
+        }
+        return true;
+    }
+
+    bool holds(long actual, const std::string &op, long value)
+    {
+        if (op == "==")
+            return actual == value;
+        if (op == ">=")
+            return actual >= value;
+        if (op == "<=")
+            return actual <= value;
+        return false;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Script script;
+    if (argc < 2 || !load(argv[1], script))
+    {
+        fprintf(stderr, "usage: %s <script>\n", argv[0]);
+        return 2;
+    }
+
+    LittleFS.begin();
+    LittleFS.content(TRACE_PATH) = script.text;
+
+    XYSimulator simulator;
+    simulator.begin(script.interval, script.speedup);
+    simulator.setNoise(script.noise, script.seed);
+    bool replaying = simulator.replay(LittleFS, TRACE_PATH);
+
+    XYUartIngest ingest;
+    ingest.begin(&simulator);
+
+    XYCommandQueue commands;
+    commands.begin(&simulator);
+
+    std::map<std::string, long> counters;
+    commands.onComplete([&](const XYCommand &cmd)
+                        { counters[cmd.state == XY_CMD_TIMEOUT ? "timeout" : "done"]++; });
+
+    PublishPolicy policy;
+    if (!script.policy.empty())
+    {
+        PublishPolicyConfig cfg = policy.config();
+        if (!PublishPolicy::parseConfig(script.policy.c_str(), cfg))
+        {
+            fprintf(stderr, "%s: bad policy \"%s\"\n", argv[1], script.policy.c_str());
+            return 2;
+        }
+        policy.setConfig(cfg);
+    }
+
+    unsigned long start = millis();
+    char line[XYUartIngest::LINE_SIZE];
+    while (millis() - start < script.runMs)
+    {
+        host::advanceMillis(STEP_MS);
+        unsigned long elapsed = millis() - start;
+
+        for (Send &send : script.sends)
+        {
+            if (!send.done && elapsed >= send.at)
+            {
+                send.done = true;
+                if (!commands.enqueue(send.command.c_str(), XY_CMD_HTTP))
+                    counters["rejected"]++;
+            }
+        }
+
+        host::runScheduled();
+        ingest.pump();
+        while (ingest.readLine(line, sizeof(line)))
+        {
+            XYFrame frame;
+            switch (XYParser::classify(line, frame))
+            {
+            case XY_FRAME_DATA:
+                counters["data"]++;
+                if (policy.offer(frame.packet, millis()))
+                    counters["published"]++;
+                continue;
+            case XY_FRAME_CONFIG:
+                counters["config"]++;
+                break;
+            default:
+                counters["raw"]++;
+                break;
+            }
+            commands.onLine(line);
+        }
+
+        XYPacket packet;
+        if (policy.poll(packet, millis()))
+            counters["published"]++;
+        commands.loop();
+    }
+
+    const XYUartStats &uart = ingest.stats();
+    counters["lines"] = uart.lines;
+    counters["garbled"] = uart.garbledLines;
+    counters["truncated"] = uart.truncatedLines;
+    counters["overruns"] = uart.overruns + simulator.stats().overruns;
+    counters["damaged"] = simulator.stats().damaged;
+    counters["commands"] = simulator.stats().commands;
+    counters["replaying"] = replaying;
+
+    int failed = 0;
+    for (const Expect &expect : script.expects)
+    {
+        long actual = counters[expect.counter];
+        bool ok = holds(actual, expect.op, expect.value);
+        printf("%s %s %s %ld (actual %ld)\n", ok ? "ok  " : "FAIL", expect.counter.c_str(),
+               expect.op.c_str(), expect.value, actual);
+        if (!ok)
+        {
+            fprintf(stderr, "%s:%d: expectation failed\n", argv[1], expect.line);
+            failed++;
+        }
+    }
+    if (script.expects.empty())
+    {
+        fprintf(stderr, "%s: no expectations\n", argv[1]);
+        return 2;
+    }
+    return failed ? 1 : 0;
+}
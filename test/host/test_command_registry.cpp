@@ -0,0 +1,75 @@
+// CommandRegistry: a batch whose first handler publishes (and so
+// overwrites PubSubClient's buffer) still runs the rest as sent.
+
+#include "HostTest.h"
+#include "CommandRegistry.h"
+
+#include <string>
+
+namespace
+{
+    // stands in for PubSubClient's buffer, shared by received and sent messages
+    char mqttBuffer[512];
+    std::string echoed;
+
+    CommandStatus cmdPublish(const CommandArg &, JsonObject)
+    {
+        // what a publish from a handler (status, policy ack) does to the payload
+        memset(mqttBuffer, '#', sizeof(mqttBuffer) - 1);
+        return CMD_OK;
+    }
+
+    CommandStatus cmdEcho(const CommandArg &arg, JsonObject)
+    {
+        echoed = arg.str;
+        return CMD_OK;
+    }
+
+    constexpr CommandSpec TABLE[] = {
+        {"publish_policy", CMD_ARG_STRING, 0, 64, cmdPublish},
+        {"echo", CMD_ARG_STRING, 0, 64, cmdEcho},
+    };
+    const CommandRegistry registry(TABLE, 2);
+
+    void receive(const char *message, JsonDocument &doc)
+    {
+        strlcpy(mqttBuffer, message, sizeof(mqttBuffer));
+        CHECK(!CommandRegistry::parse(doc, (const uint8_t *)mqttBuffer, strlen(mqttBuffer)));
+    }
+}
+
+TEST(batch_survives_a_publishing_handler)
+{
+    StaticJsonDocument<1024> doc;
+    receive(R"({"receiver":"xy","commands":[)"
+            R"({"action":"publish_policy","value":"dv=5","id":"a1"},)"
+            R"({"action":"echo","value":"second","id":"b2"}]})",
+            doc);
+
+    StaticJsonDocument<512> reply;
+    JsonArray results = reply.createNestedArray("results");
+    echoed.clear();
+    registry.dispatch(doc.as<JsonVariantConst>(), results);
+
+    CHECK_EQ(echoed, std::string("second"));
+    char out[256];
+    serializeJson(reply, out, sizeof(out));
+    CHECK_EQ(std::string(out), std::string(R"({"results":[)"
+                                           R"({"id":"a1","action":"publish_policy","status":"ok"},)"
+                                           R"({"id":"b2","action":"echo","status":"ok"}]})"));
+}
+
+TEST(unknown_action_and_bad_value)
+{
+    StaticJsonDocument<512> doc;
+    receive(R"({"commands":[{"action":"nope"},{"action":"echo","value":7}]})", doc);
+
+    StaticJsonDocument<512> reply;
+    JsonArray results = reply.createNestedArray("results");
+    registry.dispatch(doc.as<JsonVariantConst>(), results);
+
+    CHECK_EQ(results[0]["status"].as<const char *>(), "unknown");
+    CHECK_EQ(results[1]["status"].as<const char *>(), "bad_arg");
+}
+
+HOST_TEST_MAIN()
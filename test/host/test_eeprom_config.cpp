@@ -0,0 +1,141 @@
+// EEPROMConfigManager on the emulated EEPROM sector: legacy migration,
+// A/B slots across torn commits, never going back to the legacy layout.
+
+#include "HostTest.h"
+#include "EEPROMConfigManager.h"
+
+namespace
+{
+    void eraseFlash()
+    {
+        EEPROM = EEPROMClass();
+    }
+
+    // a device still on the per-field layout
+    void writeLegacy(const char *ssid, const char *clientId)
+    {
+        eraseFlash();
+        memset(EEPROM.flash, 0, EEPROMConfigManager::OFFSET_SLOT_A);
+        strcpy((char *)EEPROM.flash + EEPROMConfigManager::OFFSET_WIFI_SSID, ssid);
+        strcpy((char *)EEPROM.flash + EEPROMConfigManager::OFFSET_MQTT_PORT, "8883");
+        strcpy((char *)EEPROM.flash + EEPROMConfigManager::OFFSET_MQTT_CLIENT_ID, clientId);
+    }
+
+    std::string ssidAfterReboot(EEPROMConfigManager &config)
+    {
+        EEPROM.powerCycle();
+        config = EEPROMConfigManager();
+        config.begin();
+        char ssid[64];
+        char pass[64];
+        config.loadWiFiConfig(ssid, pass);
+        return ssid;
+    }
+}
+
+TEST(fresh_device_gets_defaults)
+{
+    eraseFlash();
+    EEPROMConfigManager config;
+    config.begin();
+    CHECK_EQ(config.loadedSlot(), 'A');
+    char server[64], user[64], pass[64], clientId[64];
+    uint16_t port = 0;
+    config.loadMQTTConfig(server, &port, user, pass, clientId);
+    CHECK_EQ(port, 1883);
+    CHECK_EQ(server, "");
+}
+
+TEST(legacy_layout_is_migrated_then_erased)
+{
+    writeLegacy("old-ssid", "old-client");
+    EEPROMConfigManager config;
+    config.begin();
+
+    char server[64], user[64], pass[64], clientId[64];
+    uint16_t port = 0;
+    config.loadMQTTConfig(server, &port, user, pass, clientId);
+    CHECK_EQ(port, 8883);
+    CHECK_EQ(clientId, "old-client");
+    CHECK_EQ(EEPROM.commits, 1u);
+    CHECK_EQ(ssidAfterReboot(config), "old-ssid");
+
+    // the next save erases the legacy area
+    config.saveAuth("admin", "secret");
+    CHECK(config.commit());
+    bool erased = true;
+    for (int addr = 0; addr < EEPROMConfigManager::OFFSET_SLOT_A; addr++)
+        erased = erased && EEPROM.flash[addr] == 0xFF;
+    CHECK(erased);
+    CHECK_EQ(ssidAfterReboot(config), "old-ssid");
+}
+
+TEST(torn_record_write_keeps_the_previous_slot)
+{
+    eraseFlash();
+    EEPROMConfigManager config;
+    config.begin(); // defaults in A
+    config.saveWiFiConfig("first", "pass");
+    CHECK(config.commit()); // B
+    config.saveWiFiConfig("second", "pass");
+    CHECK(config.commit()); // A
+    CHECK_EQ(config.loadedSlot(), 'A');
+
+    // cut while slot B is written: A holds "second"
+    config.saveWiFiConfig("third", "pass");
+    EEPROM.failNextCommit = true;
+    EEPROM.failedCommitBytes = EEPROMConfigManager::OFFSET_SLOT_B + 100;
+    CHECK(!config.commit());
+    CHECK_EQ(ssidAfterReboot(config), "second");
+    CHECK_EQ(config.loadedSlot(), 'A');
+}
+
+TEST(both_slots_damaged_never_restores_the_legacy_config)
+{
+    writeLegacy("stale-ssid", "stale-client");
+    EEPROMConfigManager config;
+    config.begin(); // migrated into A
+    config.saveWiFiConfig("new-ssid", "pass");
+    CHECK(config.commit()); // B
+
+    // cut inside slot A: the sector erase took B, A is half written
+    config.saveWiFiConfig("newer-ssid", "pass");
+    EEPROM.failNextCommit = true;
+    EEPROM.failedCommitBytes = EEPROMConfigManager::OFFSET_SLOT_A + 100;
+    CHECK(!config.commit());
+
+    CHECK_EQ(ssidAfterReboot(config), "");
+    char server[64], user[64], pass[64], clientId[64];
+    uint16_t port = 0;
+    config.loadMQTTConfig(server, &port, user, pass, clientId);
+    CHECK_EQ(clientId, "");
+    CHECK_EQ(port, 1883);
+}
+
+TEST(cut_before_the_slots_are_rewritten_loads_defaults)
+{
+    writeLegacy("stale-ssid", "stale-client");
+    EEPROMConfigManager config;
+    config.begin(); // migrated into A
+    config.saveWiFiConfig("new-ssid", "pass");
+
+    // only the (now erased) legacy area made it back, no record header
+    EEPROM.failNextCommit = true;
+    EEPROM.failedCommitBytes = EEPROMConfigManager::OFFSET_SLOT_A;
+    CHECK(!config.commit());
+    CHECK_EQ(ssidAfterReboot(config), "");
+}
+
+TEST(torn_migration_is_migrated_again)
+{
+    writeLegacy("old-ssid", "old-client");
+    EEPROM.failNextCommit = true;
+    EEPROM.failedCommitBytes = EEPROMConfigManager::OFFSET_SLOT_A;
+    EEPROMConfigManager config;
+    config.begin();
+
+    // the record never got its magic, the legacy bytes are still the source
+    CHECK_EQ(ssidAfterReboot(config), "old-ssid");
+}
+
+HOST_TEST_MAIN()
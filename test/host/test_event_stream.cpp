@@ -0,0 +1,76 @@
+// EventStream: framing, drop-oldest for a slow client, oversize events.
+
+#include "HostTest.h"
+#include "EventStream.h"
+
+#include <string>
+
+namespace
+{
+    size_t count(const std::string &text, const std::string &what)
+    {
+        size_t n = 0;
+        for (size_t at = text.find(what); at != std::string::npos; at = text.find(what, at + 1))
+            n++;
+        return n;
+    }
+}
+
+TEST(pushed_event_is_framed)
+{
+    EventStream events;
+    WiFiClient client = WiFiClient::open();
+    CHECK(events.subscribe(client));
+
+    events.push("data", "{\"v\":12.5}");
+    events.loop();
+    CHECK_EQ(client.out(), std::string("event: data\ndata: {\"v\":12.5}\n\n"));
+}
+
+TEST(largest_event_fits_a_slot)
+{
+    EventStream events;
+    WiFiClient client = WiFiClient::open();
+    events.subscribe(client);
+
+    // a full jsonBuffer[256] of the .ino under the longest event name
+    std::string data(EventStream::DATA_SIZE - 1, 'x');
+    events.push("config", data.c_str());
+    events.loop();
+    CHECK_EQ(events.tooLong(), 0u);
+    CHECK_EQ(client.out().size(), strlen("event: config\ndata: ") + data.size() + 2);
+}
+
+TEST(oversize_event_is_counted_not_sent)
+{
+    EventStream events;
+    WiFiClient client = WiFiClient::open();
+    events.subscribe(client);
+
+    std::string data(EventStream::EVENT_SIZE, 'x');
+    events.push("raw", data.c_str());
+    events.push("data", "{}");
+    events.loop();
+    CHECK_EQ(events.tooLong(), 1u);
+    CHECK_EQ(client.out(), std::string("event: data\ndata: {}\n\n"));
+}
+
+TEST(slow_client_loses_oldest_events)
+{
+    EventStream events;
+    WiFiClient client = WiFiClient::open();
+    events.subscribe(client);
+    client.setWindow(0);
+
+    for (int i = 0; i < EventStream::QUEUE_SIZE + 3; i++)
+        events.push("data", "{}");
+    events.loop();
+    CHECK(client.out().empty());
+
+    client.setWindow(4096);
+    events.loop();
+    CHECK_EQ(events.dropped(), 3u);
+    CHECK_EQ(count(client.out(), "event: data\n"), (size_t)EventStream::QUEUE_SIZE);
+}
+
+HOST_TEST_MAIN()
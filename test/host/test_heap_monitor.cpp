@@ -0,0 +1,102 @@
+// HeapMonitor::check over a scripted largest-free-block sequence:
+// a reconnect episode ends only after a healthy connected minute,
+// repeated reconnects escalate to a restart.
+
+#include "HostTest.h"
+#include "HeapMonitor.h"
+
+namespace
+{
+    HeapAction checkAt(HeapMonitor &heap, uint32_t maxBlock, bool connected)
+    {
+        ESP.maxBlock = maxBlock;
+        heap.sample("task");
+        return heap.check(connected);
+    }
+
+    HeapMonitor monitor(uint32_t handshakeBlock)
+    {
+        HeapMonitor heap;
+        heap.setThresholds(8192, 6144);
+        heap.setHandshakeBlock(handshakeBlock);
+        return heap;
+    }
+}
+
+TEST(healthy_heap_does_nothing)
+{
+    HeapMonitor heap = monitor(837);
+    for (int i = 0; i < 20; i++)
+        CHECK_EQ(checkAt(heap, 20000, i % 2), HEAP_OK);
+    CHECK_EQ(heap.reconnects(), 0);
+}
+
+TEST(recovery_right_after_the_disconnect_does_not_end_the_episode)
+{
+    HeapMonitor heap = monitor(837);
+    // block drops with TLS up, recovers while down (buffers freed), drops
+    // again once TLS is back: reconnect, reconnect, reconnect, restart
+    for (int round = 0; round < HeapMonitor::MAX_RECONNECTS; round++)
+    {
+        CHECK_EQ(checkAt(heap, 7000, true), HEAP_RECONNECT);
+        CHECK_EQ(checkAt(heap, 20000, false), HEAP_OK);
+        CHECK_EQ(checkAt(heap, 9000, true), HEAP_OK);
+    }
+    CHECK_EQ(heap.reconnects(), HeapMonitor::MAX_RECONNECTS);
+    CHECK_EQ(checkAt(heap, 7000, true), HEAP_RESTART);
+}
+
+TEST(healthy_connected_minute_ends_the_episode)
+{
+    HeapMonitor heap = monitor(837);
+    CHECK_EQ(checkAt(heap, 7000, true), HEAP_RECONNECT);
+    CHECK_EQ(checkAt(heap, 20000, false), HEAP_OK);
+    for (int i = 0; i < HeapMonitor::RECOVERY_CHECKS; i++)
+        CHECK_EQ(checkAt(heap, 9000, true), HEAP_OK);
+
+    // a new episode starts with a reconnect again, not a restart
+    for (int i = 0; i < HeapMonitor::MAX_RECONNECTS; i++)
+    {
+        CHECK_EQ(checkAt(heap, 7000, true), HEAP_RECONNECT);
+        for (int j = 0; j < HeapMonitor::RECOVERY_CHECKS; j++)
+            CHECK_EQ(checkAt(heap, 9000, true), HEAP_OK);
+    }
+    CHECK_EQ(heap.reconnects(), 1 + HeapMonitor::MAX_RECONNECTS);
+}
+
+TEST(still_below_restart_block_after_the_reconnect)
+{
+    HeapMonitor heap = monitor(837);
+    CHECK_EQ(checkAt(heap, 7000, true), HEAP_RECONNECT);
+    CHECK_EQ(checkAt(heap, 5000, false), HEAP_RESTART);
+}
+
+TEST(without_mfln_the_handshake_buffer_must_fit)
+{
+    // 16 KB records: a 12 KB block is plenty beside an open connection but
+    // cannot hold the RX buffer of the next handshake
+    HeapMonitor full = monitor(16384 + 325);
+    CHECK_EQ(checkAt(full, 7000, true), HEAP_RECONNECT);
+    CHECK_EQ(checkAt(full, 12000, false), HEAP_RESTART);
+
+    HeapMonitor mfln = monitor(512 + 325);
+    CHECK_EQ(checkAt(mfln, 7000, true), HEAP_RECONNECT);
+    CHECK_EQ(checkAt(mfln, 12000, false), HEAP_OK);
+}
+
+TEST(disconnected_without_an_episode_is_left_alone)
+{
+    // the broker being down is not a heap problem
+    HeapMonitor heap = monitor(16384 + 325);
+    CHECK_EQ(checkAt(heap, 5000, false), HEAP_OK);
+    CHECK_EQ(heap.reconnects(), 0);
+}
+
+TEST(zero_threshold_is_off)
+{
+    HeapMonitor heap;
+    heap.setThresholds(0, 0);
+    CHECK_EQ(checkAt(heap, 100, true), HEAP_OK);
+}
+
+HOST_TEST_MAIN()
@@ -0,0 +1,69 @@
+// HeartbeatPolicy: the connect heartbeat, RSSI hysteresis around the last
+// published value, rate limit and keepalive.
+
+#include "HostTest.h"
+#include "HeartbeatPolicy.h"
+
+namespace
+{
+    const uint32_t IP = 0x3201A8C0; // 192.168.1.50
+
+    HeartbeatPolicy policy()
+    {
+        HeartbeatPolicy heartbeat;
+        heartbeat.configure(300000, 5000, 10);
+        return heartbeat;
+    }
+}
+
+TEST(connect_is_published_once)
+{
+    HeartbeatPolicy heartbeat = policy();
+    CHECK_EQ(heartbeat.connected(IP, -60, 1000), HEARTBEAT_CONNECT);
+    CHECK_EQ(heartbeat.published(), 1u);
+    // the status task right after it has nothing to add
+    for (unsigned long now = 2000; now < 60000; now += 1000)
+        CHECK_EQ(heartbeat.offer(IP, -60, true, now), HEARTBEAT_NONE);
+}
+
+TEST(rssi_hovering_at_a_bucket_edge_stays_quiet)
+{
+    HeartbeatPolicy heartbeat = policy();
+    heartbeat.connected(IP, -60, 0);
+    // -60/-61 crossed a 10 dB bucket edge on every sample before
+    for (unsigned long now = 10000; now < 200000; now += 10000)
+        CHECK_EQ(heartbeat.offer(IP, (now / 10000) % 2 ? -61 : -59, true, now), HEARTBEAT_NONE);
+    CHECK_EQ(heartbeat.published(), 1u);
+}
+
+TEST(rssi_move_of_a_bucket_is_published)
+{
+    HeartbeatPolicy heartbeat = policy();
+    heartbeat.connected(IP, -60, 0);
+    CHECK_EQ(heartbeat.offer(IP, -69, true, 10000), HEARTBEAT_NONE);
+    CHECK_EQ(heartbeat.offer(IP, -70, true, 11000), HEARTBEAT_RSSI);
+    // measured from -70 now
+    CHECK_EQ(heartbeat.offer(IP, -61, true, 20000), HEARTBEAT_NONE);
+    CHECK_EQ(heartbeat.offer(IP, -80, true, 21000), HEARTBEAT_RSSI);
+}
+
+TEST(changes_are_rate_limited)
+{
+    HeartbeatPolicy heartbeat = policy();
+    heartbeat.connected(IP, -60, 0);
+    CHECK_EQ(heartbeat.offer(IP + 1, -60, true, 4999), HEARTBEAT_NONE);
+    CHECK_EQ(heartbeat.offer(IP + 1, -60, true, 5000), HEARTBEAT_IP);
+    CHECK_EQ(heartbeat.offer(IP + 1, -90, true, 6000), HEARTBEAT_NONE);
+    CHECK_EQ(heartbeat.offer(IP + 1, -90, true, 10000), HEARTBEAT_RSSI);
+}
+
+TEST(keepalive_and_disconnected)
+{
+    HeartbeatPolicy heartbeat = policy();
+    heartbeat.connected(IP, -60, 0);
+    CHECK_EQ(heartbeat.offer(IP, -60, true, 299999), HEARTBEAT_NONE);
+    CHECK_EQ(heartbeat.offer(IP, -60, false, 300000), HEARTBEAT_NONE);
+    CHECK_EQ(heartbeat.offer(IP, -60, true, 300000), HEARTBEAT_KEEPALIVE);
+}
+
+HOST_TEST_MAIN()
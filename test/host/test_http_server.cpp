@@ -0,0 +1,131 @@
+// HttpConfigServer on the ESP8266WebServer stand-in: auth and the
+// /send -> queue -> simulated UART -> /result round trip.
+
+#include "HostTest.h"
+#include "HttpConfigServer.h"
+#include "XYSimulator.h"
+#include "XYUartIngest.h"
+#include "LoopMetrics.h"
+#include "TelemetryHistory.h"
+#include <lwip/opt.h>
+
+namespace
+{
+    struct Bench
+    {
+        XYSimulator simulator;
+        XYCommandQueue queue;
+        HttpConfigServer config;
+        ESP8266WebServer &server;
+
+        Bench() : server(*ESP8266WebServer::last())
+        {
+            simulator.begin(1000, 1);
+            queue.begin(&simulator);
+            config.setAuth("admin", "secret");
+            config.setMQTT("broker", 1883, "", "", "xy-test");
+            config.addCommandQueue(&queue);
+            config.begin();
+            server.setCredentials("admin", "secret");
+        }
+
+        // lets the simulator answer and the queue collect the reply
+        void settle()
+        {
+            char line[XYUartIngest::LINE_SIZE];
+            XYUartIngest ingest;
+            ingest.begin(&simulator);
+            for (int i = 0; i < 100; i++)
+            {
+                host::advanceMillis(10);
+                ingest.pump();
+                while (ingest.readLine(line, sizeof(line)))
+                {
+                    XYFrame frame;
+                    if (XYParser::classify(line, frame) != XY_FRAME_DATA)
+                        queue.onLine(line);
+                }
+                queue.loop();
+            }
+        }
+    };
+}
+
+TEST(send_requires_auth)
+{
+    Bench bench;
+    bench.server.setCredentials("admin", "wrong");
+    CHECK_EQ(bench.server.request(HTTP_GET, "/send", {{"command", "read"}}).code, 401);
+}
+
+TEST(send_and_result_round_trip)
+{
+    Bench bench;
+    const ESP8266WebServer::Response &sent = bench.server.request(HTTP_GET, "/send", {{"command", "read"}});
+    CHECK_EQ(sent.code, 202);
+    // strings are copied, the body length bounds them
+    StaticJsonDocument<JSON_OBJECT_SIZE(6) + 320> doc;
+    CHECK(!deserializeJson(doc, sent.body.c_str()));
+    uint16_t id = doc["id"];
+    CHECK(id != 0);
+    CHECK_EQ(doc["device_id"].as<const char *>(), "xy-test");
+
+    bench.settle();
+
+    char idArg[8];
+    snprintf(idArg, sizeof(idArg), "%u", id);
+    const ESP8266WebServer::Response &result = bench.server.request(HTTP_GET, "/result", {{"id", idArg}});
+    CHECK_EQ(result.code, 200);
+    CHECK(!deserializeJson(doc, result.body.c_str()));
+    CHECK_EQ(doc["status"].as<const char *>(), "done");
+    CHECK_EQ(doc["response"].as<const char *>(), "dw11.0,up13.0,00:00");
+
+    // delivered once
+    CHECK_EQ(bench.server.request(HTTP_GET, "/result", {{"id", idArg}}).code, 404);
+}
+
+TEST(empty_command_is_rejected)
+{
+    Bench bench;
+    CHECK_EQ(bench.server.request(HTTP_GET, "/send", {{"command", ""}}).code, 400);
+}
+
+TEST(history_escapes_device_id)
+{
+    Bench bench;
+    TelemetryHistory history;
+    for (uint32_t t = 0; t < TelemetryHistory::RAW_SIZE; t++)
+        history.add(XYPacket{1250, 80, 0, 0, "CL", XY_PARSE_OK}, 1700000000 + t);
+    bench.config.setHistory(&history);
+    bench.config.setMQTT("broker", 1883, "", "", "xy \"bench\"\\1\n");
+
+    const ESP8266WebServer::Response &response = bench.server.request(HTTP_GET, "/history");
+    CHECK_EQ(response.code, 200);
+    // streamed through the shared segment buffer, never more than one segment per write
+    CHECK(response.largestWrite <= TCP_MSS);
+    CHECK(response.contentWrites > 1);
+
+    DynamicJsonDocument doc(JSON_OBJECT_SIZE(3) + JSON_ARRAY_SIZE(TelemetryHistory::RAW_SIZE) +
+                            TelemetryHistory::RAW_SIZE * JSON_ARRAY_SIZE(4) + response.body.size());
+    CHECK(!deserializeJson(doc, response.body.c_str()));
+    CHECK_EQ(doc["device_id"].as<const char *>(), "xy \"bench\"\\1\n");
+    JsonVariantConst samples = doc["samples"];
+    CHECK_EQ(samples.size(), (size_t)TelemetryHistory::RAW_SIZE);
+}
+
+TEST(metrics_count_undelivered_events)
+{
+    Bench bench;
+    LoopMetrics metrics;
+    bench.config.setMetrics(&metrics);
+
+    std::string tooLong(EventStream::EVENT_SIZE, 'x');
+    bench.config.pushEvent("raw", tooLong.c_str());
+
+    const ESP8266WebServer::Response &response = bench.server.request(HTTP_GET, "/metrics");
+    CHECK_EQ(response.code, 200);
+    CHECK(response.body.find("xy_events_dropped_total{reason=\"slow_client\"} 0\n") != std::string::npos);
+    CHECK(response.body.find("xy_events_dropped_total{reason=\"too_long\"} 1\n") != std::string::npos);
+}
+
+HOST_TEST_MAIN()
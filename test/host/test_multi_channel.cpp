@@ -0,0 +1,152 @@
+// Several XY-Lx0A units (XYChannel) on one bridge, each on its own
+// simulator: lines and replies stay on their unit, /send and /result
+// route by ?unit=, the batch frame names its unit.
+
+#include "HostTest.h"
+#include "HttpConfigServer.h"
+#include "XYChannel.h"
+#include "XYSimulator.h"
+
+#include <string>
+
+namespace
+{
+    const char *const UNITS[] = {"1", "2", "3"};
+    const uint8_t UNIT_COUNT = 3;
+
+    struct Bridge
+    {
+        XYSimulator simulators[UNIT_COUNT];
+        XYChannel channels[UNIT_COUNT];
+        uint32_t dataLines[UNIT_COUNT] = {};
+        HttpConfigServer config;
+        ESP8266WebServer &server;
+
+        Bridge() : server(*ESP8266WebServer::last())
+        {
+            config.setAuth("admin", "secret");
+            config.setMQTT("broker", 1883, "", "", "xy-bridge");
+            for (uint8_t i = 0; i < UNIT_COUNT; i++)
+            {
+                // different intervals, so the units are not in step
+                simulators[i].begin(1000 + 250 * i, 1);
+                channels[i].unit = UNITS[i];
+                channels[i].ingest.begin(&simulators[i]);
+                channels[i].commands.begin(&simulators[i]);
+                channels[i].batcher.configure(4, 60);
+                config.addCommandQueue(&channels[i].commands, channels[i].unit);
+            }
+            config.begin();
+            server.setCredentials("admin", "secret");
+        }
+
+        // the "uart" task of the firmware, for every unit
+        void run(unsigned long ms)
+        {
+            char line[XYUartIngest::LINE_SIZE];
+            for (unsigned long t = 0; t < ms; t += 10)
+            {
+                host::advanceMillis(10);
+                for (uint8_t i = 0; i < UNIT_COUNT; i++)
+                {
+                    XYChannel &ch = channels[i];
+                    ch.ingest.pump();
+                    while (ch.ingest.readLine(line, sizeof(line)))
+                    {
+                        XYFrame frame;
+                        if (XYParser::classify(line, frame) == XY_FRAME_DATA)
+                        {
+                            dataLines[i]++;
+                            ch.batcher.add(frame.packet, millis());
+                        }
+                        else
+                            ch.commands.onLine(line);
+                    }
+                    ch.commands.loop();
+                }
+            }
+        }
+
+        // /send then /result on one unit, returns the module's reply
+        std::string command(const char *unit, const char *cmd)
+        {
+            const ESP8266WebServer::Response &sent = server.request(HTTP_GET, "/send", {{"command", cmd}, {"unit", unit}});
+            CHECK_EQ(sent.code, 202);
+            // strings are copied, the body length bounds them
+            StaticJsonDocument<JSON_OBJECT_SIZE(6) + 320> doc;
+            CHECK(!deserializeJson(doc, sent.body.c_str()));
+            CHECK_EQ(doc["unit"].as<const char *>(), unit);
+            char id[8];
+            snprintf(id, sizeof(id), "%u", doc["id"].as<unsigned>());
+
+            run(1000);
+            const ESP8266WebServer::Response &result = server.request(HTTP_GET, "/result", {{"id", id}, {"unit", unit}});
+            CHECK_EQ(result.code, 200);
+            CHECK(!deserializeJson(doc, result.body.c_str()));
+            CHECK_EQ(doc["status"].as<const char *>(), "done");
+            CHECK_EQ(doc["unit"].as<const char *>(), unit);
+            return doc["response"].as<const char *>();
+        }
+    };
+}
+
+TEST(every_unit_streams_its_own_lines)
+{
+    Bridge bridge;
+    bridge.run(12000);
+    // 12 s at 1 s, 1.25 s and 1.5 s intervals
+    CHECK(bridge.dataLines[0] >= 11 && bridge.dataLines[0] <= 12);
+    CHECK(bridge.dataLines[1] >= 9 && bridge.dataLines[1] <= 10);
+    CHECK(bridge.dataLines[2] >= 7 && bridge.dataLines[2] <= 8);
+    for (uint8_t i = 0; i < UNIT_COUNT; i++)
+        CHECK_EQ(bridge.simulators[i].stats().lines, bridge.dataLines[i]);
+}
+
+TEST(send_routes_by_unit)
+{
+    Bridge bridge;
+    bridge.command("2", "dw10.5");
+    CHECK_EQ(bridge.command("2", "read"), std::string("dw10.5,up13.0,00:00"));
+    // the other units did not get it
+    CHECK_EQ(bridge.command("1", "read"), std::string("dw11.0,up13.0,00:00"));
+    CHECK_EQ(bridge.command("3", "read"), std::string("dw11.0,up13.0,00:00"));
+}
+
+TEST(result_ids_are_per_unit)
+{
+    Bridge bridge;
+    const ESP8266WebServer::Response &sent = bridge.server.request(HTTP_GET, "/send", {{"command", "read"}, {"unit", "3"}});
+    CHECK_EQ(sent.code, 202);
+    StaticJsonDocument<JSON_OBJECT_SIZE(5) + 192> doc;
+    CHECK(!deserializeJson(doc, sent.body.c_str()));
+    char id[8];
+    snprintf(id, sizeof(id), "%u", doc["id"].as<unsigned>());
+    bridge.run(1000);
+
+    CHECK_EQ(bridge.server.request(HTTP_GET, "/result", {{"id", id}, {"unit", "1"}}).code, 404);
+    CHECK_EQ(bridge.server.request(HTTP_GET, "/result", {{"id", id}, {"unit", "3"}}).code, 200);
+}
+
+TEST(unknown_unit_is_rejected)
+{
+    Bridge bridge;
+    CHECK_EQ(bridge.server.request(HTTP_GET, "/send", {{"command", "read"}, {"unit", "9"}}).code, 404);
+    // no ?unit= is the first unit
+    CHECK_EQ(bridge.server.request(HTTP_GET, "/send", {{"command", "read"}}).code, 202);
+}
+
+TEST(batch_frame_names_its_unit)
+{
+    Bridge bridge;
+    bridge.run(3000);
+    char frame[512];
+    CHECK(bridge.channels[1].batcher.serialize(frame, sizeof(frame), "xy-bridge", bridge.channels[1].unit) > 0);
+    StaticJsonDocument<JSON_OBJECT_SIZE(5) + JSON_ARRAY_SIZE(TelemetryBatcher::MAX_SAMPLES) +
+                       TelemetryBatcher::MAX_SAMPLES * JSON_ARRAY_SIZE(5) + sizeof(frame)>
+        doc;
+    CHECK(!deserializeJson(doc, (const char *)frame));
+    CHECK_EQ(doc["device_id"].as<const char *>(), "xy-bridge");
+    CHECK_EQ(doc["unit"].as<const char *>(), "2");
+}
+
+HOST_TEST_MAIN()
@@ -0,0 +1,47 @@
+// TelemetryBatcher frames are valid JSON whatever the client id and unit
+// hold, and a frame that does not fit is not written at all.
+
+#include "HostTest.h"
+#include "TelemetryBatcher.h"
+#include <ArduinoJson.h>
+
+namespace
+{
+    const XYPacket PACKET = {1250, 80, 1, 5, "CL", XY_PARSE_OK};
+}
+
+TEST(client_id_and_unit_are_escaped)
+{
+    TelemetryBatcher batcher;
+    batcher.configure(4, 60);
+    batcher.add(PACKET, millis());
+    batcher.add(PACKET, millis() + 1000);
+
+    const char *id = "xy \"bench\"\\1\n";
+    char frame[512];
+    CHECK(batcher.serialize(frame, sizeof(frame), id, "a\"b") > 0);
+
+    StaticJsonDocument<JSON_OBJECT_SIZE(5) + JSON_ARRAY_SIZE(2) + 2 * JSON_ARRAY_SIZE(5) + sizeof(frame)> doc;
+    CHECK(!deserializeJson(doc, (const char *)frame));
+    CHECK_EQ(doc["device_id"].as<const char *>(), id);
+    CHECK_EQ(doc["unit"].as<const char *>(), "a\"b");
+    JsonVariantConst samples = doc["samples"];
+    CHECK_EQ(samples.size(), (size_t)2);
+    CHECK_EQ(samples[1][4].as<const char *>(), "CL");
+}
+
+TEST(frame_that_does_not_fit_is_not_written)
+{
+    TelemetryBatcher batcher;
+    batcher.configure(4, 60);
+    batcher.add(PACKET, millis());
+
+    char frame[512];
+    size_t len = batcher.serialize(frame, sizeof(frame), "xy");
+    CHECK(len > 0);
+    for (size_t size = 1; size <= len; size++)
+        CHECK_EQ(batcher.serialize(frame, size, "xy"), (size_t)0);
+    CHECK_EQ(batcher.serialize(frame, len + 1, "xy"), len);
+}
+
+HOST_TEST_MAIN()
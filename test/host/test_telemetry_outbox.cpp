@@ -0,0 +1,187 @@
+// TelemetryOutbox on the in-memory LittleFS: drained records stay
+// drained across a reboot, segments roll over and evict.
+
+#include "HostTest.h"
+#include <LittleFS.h>
+#include "TelemetryOutbox.h"
+
+namespace
+{
+    void freshFs()
+    {
+        LittleFS.format();
+        LittleFS.begin();
+    }
+
+    struct Sink
+    {
+        std::vector<std::string> topics;
+        std::vector<std::string> payloads;
+        bool accept = true;
+
+        TelemetryOutbox::PublishFn fn()
+        {
+            return [this](const char *topic, const uint8_t *payload, size_t len)
+            {
+                if (!accept)
+                    return false;
+                topics.push_back(topic);
+                payloads.push_back(std::string((const char *)payload, len));
+                return true;
+            };
+        }
+    };
+
+    void appendN(TelemetryOutbox &outbox, int from, int count)
+    {
+        for (int i = from; i < from + count; i++)
+        {
+            char payload[48];
+            snprintf(payload, sizeof(payload), "{\"type\":\"data\",\"n\":%d,\"pad\":\"xxxxxxxxxxxx\"}", i);
+            CHECK(outbox.append("xy/test/data", payload));
+        }
+    }
+}
+
+TEST(empty_outbox_has_no_segments)
+{
+    freshFs();
+    TelemetryOutbox outbox;
+    CHECK(outbox.begin());
+    CHECK(outbox.empty());
+    CHECK_EQ(outbox.segments(), 0);
+}
+
+TEST(drained_records_are_not_replayed_after_reboot)
+{
+    freshFs();
+    Sink sink;
+    {
+        TelemetryOutbox outbox;
+        outbox.begin();
+        appendN(outbox, 0, 3);
+        CHECK_EQ(outbox.segments(), 1);
+        CHECK_EQ(outbox.drain(sink.fn(), 10), 3);
+        CHECK(outbox.empty());
+        CHECK_EQ(outbox.segments(), 0);
+        CHECK_EQ(LittleFS.fileCount(), 0u);
+    }
+
+    TelemetryOutbox rebooted;
+    rebooted.begin();
+    CHECK(rebooted.empty());
+    CHECK_EQ(rebooted.drain(sink.fn(), 10), 0);
+    CHECK_EQ(sink.payloads.size(), 3u);
+}
+
+TEST(appends_after_a_full_drain_are_sent_once)
+{
+    freshFs();
+    Sink sink;
+    TelemetryOutbox outbox;
+    outbox.begin();
+    appendN(outbox, 0, 2);
+    CHECK_EQ(outbox.drain(sink.fn(), 10), 2);
+    appendN(outbox, 2, 2);
+    CHECK_EQ(outbox.drain(sink.fn(), 10), 2);
+    CHECK_EQ(sink.payloads.size(), 4u);
+    CHECK(sink.payloads[2].find("\"n\":2") != std::string::npos);
+}
+
+TEST(partial_drain_repeats_the_segment_after_reboot)
+{
+    freshFs();
+    Sink sink;
+    {
+        TelemetryOutbox outbox;
+        outbox.begin();
+        appendN(outbox, 0, 3);
+        CHECK_EQ(outbox.drain(sink.fn(), 1), 1);
+    }
+
+    // at-least-once: the read offset is not persisted
+    TelemetryOutbox rebooted;
+    rebooted.begin();
+    CHECK_EQ(rebooted.drain(sink.fn(), 10), 3);
+    CHECK(rebooted.empty());
+    CHECK_EQ(LittleFS.fileCount(), 0u);
+}
+
+TEST(failed_publish_keeps_the_record)
+{
+    freshFs();
+    Sink sink;
+    TelemetryOutbox outbox;
+    outbox.begin();
+    appendN(outbox, 0, 2);
+    sink.accept = false;
+    CHECK_EQ(outbox.drain(sink.fn(), 10), 0);
+    CHECK(!outbox.empty());
+    sink.accept = true;
+    CHECK_EQ(outbox.drain(sink.fn(), 10), 2);
+    CHECK(outbox.empty());
+}
+
+TEST(segments_roll_over_and_evict_the_oldest)
+{
+    freshFs();
+    Sink sink;
+    TelemetryOutbox outbox;
+    outbox.begin();
+    // ~60 byte records: 4096 / 60 per segment, 1000 of them overflow 8 segments
+    appendN(outbox, 0, 1000);
+    CHECK_EQ(outbox.segments(), TelemetryOutbox::MAX_SEGMENTS);
+    CHECK(outbox.dropped() > 0);
+
+    uint16_t sent;
+    while ((sent = outbox.drain(sink.fn(), 100)) > 0)
+    {
+    }
+    CHECK_EQ(sink.payloads.size() + outbox.dropped(), 1000u);
+    CHECK(outbox.empty());
+    CHECK_EQ(outbox.segments(), 0);
+    CHECK_EQ(LittleFS.fileCount(), 0u);
+    // the newest record made it
+    CHECK(sink.payloads.back().find("\"n\":999") != std::string::npos);
+}
+
+
+TEST(binary_records_replay_byte_exact)
+{
+    freshFs();
+    TelemetryOutbox outbox;
+    CHECK(outbox.begin());
+
+    // MessagePack with a NUL, '\t' and '\n' inside
+    const uint8_t frame[] = {0x95, 0x01, 0x00, 0x09, 0x0a, 0xff, 0x3d};
+    CHECK(outbox.appendBinary("xy/test/data/bin", frame, sizeof(frame)));
+    CHECK(outbox.append("xy/test/data", "{\"n\":1}"));
+    CHECK(!outbox.appendBinary("xy/test/data/bin", frame, 0));
+
+    Sink sink;
+    CHECK_EQ(outbox.drain(sink.fn(), 10), 2);
+    CHECK_EQ(sink.topics[0], std::string("xy/test/data/bin"));
+    CHECK(sink.payloads[0] == std::string((const char *)frame, sizeof(frame)));
+    CHECK_EQ(sink.payloads[1], std::string("{\"n\":1}"));
+    CHECK(outbox.empty());
+}
+
+TEST(corrupt_binary_record_is_dropped)
+{
+    freshFs();
+    LittleFS.mkdir("/outbox");
+    {
+        File f = LittleFS.open("/outbox/00000000.log", "w");
+        f.print("xy/test/data/bin\t=9g01\nxy/test/data\t{}\n");
+        f.close();
+    }
+    TelemetryOutbox outbox;
+    CHECK(outbox.begin());
+
+    Sink sink;
+    CHECK_EQ(outbox.drain(sink.fn(), 10), 1);
+    CHECK_EQ(sink.payloads[0], std::string("{}"));
+    CHECK_EQ(outbox.dropped(), 1u);
+}
+
+HOST_TEST_MAIN()
@@ -0,0 +1,100 @@
+// Samples taken before the first NTP answer: time(nullptr) is seconds
+// since boot then. The history moves them to unix time, a batch is
+// rebased at serialize time or flagged.
+
+#include "HostTest.h"
+#include "TelemetryHistory.h"
+#include "TelemetryBatcher.h"
+
+#include <string>
+
+namespace
+{
+    const time_t BOOT = 1700000000; // unix time of boot, once NTP answered
+    const XYPacket PACKET = {1250, 80, 0, 0, "CL", XY_PARSE_OK};
+
+    void boot()
+    {
+        host::setMillis(0);
+        host::unixTimeAtBoot = 0;
+    }
+}
+
+TEST(history_is_rebased_by_the_first_synced_sample)
+{
+    boot();
+    TelemetryHistory history;
+    host::advanceMillis(30000);
+    history.add(PACKET, time(nullptr)); // 30 s after boot
+    host::advanceMillis(60000);
+    history.add(PACKET, time(nullptr)); // 90 s
+
+    host::unixTimeAtBoot = BOOT;
+    host::advanceMillis(60000);
+    history.add(PACKET, time(nullptr));
+
+    HistorySample s;
+    CHECK(history.sampleAt(0, s));
+    CHECK_EQ(s.time, (uint32_t)(BOOT + 30));
+    CHECK(history.sampleAt(1, s));
+    CHECK_EQ(s.time, (uint32_t)(BOOT + 90));
+    CHECK(history.sampleAt(2, s));
+    CHECK_EQ(s.time, (uint32_t)(BOOT + 150));
+
+    HistoryBucket b;
+    CHECK(history.bucketAt(HISTORY_1MIN, 0, b));
+    CHECK(unixTimeValid(b.start));
+    CHECK_EQ(b.start % 60, 0u);
+    CHECK(history.bucketAt(HISTORY_15MIN, history.count(HISTORY_15MIN) - 1, b));
+    CHECK(unixTimeValid(b.start));
+}
+
+TEST(synced_samples_are_left_alone)
+{
+    boot();
+    host::unixTimeAtBoot = BOOT;
+    TelemetryHistory history;
+    history.add(PACKET, time(nullptr));
+    host::advanceMillis(5000);
+    history.add(PACKET, time(nullptr));
+
+    HistorySample s;
+    CHECK(history.sampleAt(0, s));
+    CHECK_EQ(s.time, (uint32_t)BOOT);
+    CHECK(history.sampleAt(1, s));
+    CHECK_EQ(s.time, (uint32_t)(BOOT + 5));
+}
+
+TEST(batch_without_time_is_flagged)
+{
+    boot();
+    TelemetryBatcher batcher;
+    batcher.configure(4, 60);
+    host::advanceMillis(10000);
+    batcher.add(PACKET, millis());
+
+    char frame[256];
+    CHECK(batcher.serialize(frame, sizeof(frame), "xy") > 0);
+    std::string json(frame);
+    CHECK(json.find("\"ts_valid\":false") != std::string::npos);
+    CHECK(json.find("\"ts\":") == std::string::npos);
+}
+
+TEST(batch_started_before_sync_is_rebased)
+{
+    boot();
+    TelemetryBatcher batcher;
+    batcher.configure(4, 60);
+    host::advanceMillis(10000);
+    batcher.add(PACKET, millis()); // 10 s after boot
+
+    host::unixTimeAtBoot = BOOT;
+    host::advanceMillis(20000);
+    batcher.add(PACKET, millis());
+
+    char frame[256];
+    CHECK(batcher.serialize(frame, sizeof(frame), "xy") > 0);
+    CHECK(std::string(frame).find("\"ts\":1700000010,") != std::string::npos);
+}
+
+HOST_TEST_MAIN()
@@ -0,0 +1,73 @@
+// TlsResumption on a fake BearSSL::Session: only a connect that kept the
+// offered session parameters counts as resumed.
+
+#include "HostTest.h"
+#include "TlsResumption.h"
+
+namespace
+{
+    // same shape as BearSSL::Session: plain bytes, zeroed when constructed
+    struct FakeSession
+    {
+        uint8_t id[32] = {};
+        uint8_t masterSecret[48] = {};
+        uint16_t version = 0;
+
+        static FakeSession handshake(uint8_t seed)
+        {
+            FakeSession session;
+            memset(session.id, seed, sizeof(session.id));
+            memset(session.masterSecret, seed ^ 0x5a, sizeof(session.masterSecret));
+            session.version = 0x0303;
+            return session;
+        }
+    };
+}
+
+TEST(first_connect_is_a_full_handshake)
+{
+    TlsResumption<FakeSession> resumption;
+    FakeSession session;
+    resumption.offer(session);
+    session = FakeSession::handshake(1);
+    CHECK(!resumption.resumed(session));
+}
+
+TEST(kept_session_is_resumed)
+{
+    TlsResumption<FakeSession> resumption;
+    FakeSession session = FakeSession::handshake(1);
+    resumption.offer(session);
+    CHECK(resumption.resumed(session));
+}
+
+TEST(replaced_session_is_a_full_handshake)
+{
+    TlsResumption<FakeSession> resumption;
+    FakeSession session = FakeSession::handshake(1);
+    resumption.offer(session);
+    session = FakeSession::handshake(2);
+    CHECK(!resumption.resumed(session));
+
+    // the next connect offers the new session
+    resumption.offer(session);
+    CHECK(resumption.resumed(session));
+}
+
+TEST(one_changed_byte_is_a_full_handshake)
+{
+    TlsResumption<FakeSession> resumption;
+    FakeSession session = FakeSession::handshake(1);
+    resumption.offer(session);
+    session.masterSecret[47] ^= 1;
+    CHECK(!resumption.resumed(session));
+}
+
+TEST(no_session_left_is_not_resumed)
+{
+    TlsResumption<FakeSession> resumption;
+    resumption.offer(FakeSession());
+    CHECK(!resumption.resumed(FakeSession()));
+}
+
+HOST_TEST_MAIN()
@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+"""Gzips the static web panel (web/) into WebAssets.h.
+
+Run after editing anything in web/:
+
+    python3 tools/build_web_assets.py
+
+Output is reproducible (fixed gzip mtime), so WebAssets.h only changes
+when a page does. ETags are the first 16 hex digits of the SHA-1 of the
+uncompressed file; index.html gets the app.js ETag in place of
+{{APP_JS_ETAG}}, so a new script is a new URL and app.js can be cached
+forever.
+"""
+
+import gzip
+import hashlib
+import os
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+WEB_DIR = os.path.join(ROOT, "web")
+OUT = os.path.join(ROOT, "WebAssets.h")
+
+# (file, url, content type, symbol, immutable)
+ASSETS = [
+    ("app.js", "/app.js", "application/javascript", "APP_JS", True),
+    ("index.html", "/", "text/html; charset=UTF-8", "INDEX_HTML", False),
+]
+
+
+def etag(data):
+    return hashlib.sha1(data).hexdigest()[:16]
+
+
+def c_bytes(data, indent="    ", per_line=16):
+    lines = []
+    for i in range(0, len(data), per_line):
+        lines.append(indent + ", ".join("0x%02x" % b for b in data[i:i + per_line]) + ",")
+    return "\n".join(lines)
+
+
+def main():
+    tags = {}
+    blocks = []
+    table = []
+
+    for name, url, content_type, symbol, immutable in ASSETS:
+        with open(os.path.join(WEB_DIR, name), "rb") as f:
+            data = f.read()
+        for key, value in tags.items():
+            data = data.replace(("{{%s_ETAG}}" % key).encode(), value.encode())
+        tag = etag(data)
+        tags[symbol] = tag
+
+        gz = gzip.compress(data, compresslevel=9, mtime=0)
+        blocks.append("// web/%s: %d bytes, %d gzipped\n"
+                      "const uint8_t %s_GZ[] PROGMEM = {\n%s\n};\n"
+                      % (name, len(data), len(gz), symbol, c_bytes(gz)))
+        table.append('    {"%s", "%s", %s_GZ, sizeof(%s_GZ), "\\"%s\\"", %s},'
+                     % (url, content_type, symbol, symbol, tag, "true" if immutable else "false"))
+
+    with open(OUT, "w", newline="\n") as f:
+        f.write("// Generated by tools/build_web_assets.py from web/, do not edit.\n")
+        f.write("#ifndef WEB_ASSETS_H\n#define WEB_ASSETS_H\n\n#include <Arduino.h>\n\n")
+        f.write("struct WebAsset\n{\n"
+                "    const char *path;\n"
+                "    const char *contentType;\n"
+                "    const uint8_t *gzData; // PROGMEM\n"
+                "    size_t gzLength;\n"
+                "    const char *etag; // quoted, strong\n"
+                "    bool immutable;   // URL changes with the content\n"
+                "};\n\n")
+        f.write("\n".join(blocks))
+        f.write("\nconst WebAsset WEB_ASSETS[] = {\n%s\n};\n\n" % "\n".join(table))
+        f.write("#endif // WEB_ASSETS_H\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,167 @@
+function showMQTTStatus(data) {
+  const el = document.getElementById("mqttStatus");
+  if (data.mqtt === "connected") {
+    el.innerHTML = 'MQTT: <span style="color:green">Online</span>';
+  } else if (data.retry) {
+    el.innerHTML = 'MQTT: <span style="color:red">Offline</span>, retry ' + data.retry +
+      ' in ' + Math.round(data.next_ms / 1000) + ' s';
+  } else {
+    el.innerHTML = 'MQTT: <span style="color:red">Offline</span>';
+  }
+}
+
+function updateMQTTStatus() {
+  fetch('/status', { credentials: 'include' })
+    .then(r => r.json())
+    .then(showMQTTStatus);
+}
+
+// live samples, config echoes and MQTT state pushed by the device (/events);
+// polling /status is only the fallback
+function connectEvents() {
+  if (!window.EventSource) {
+    updateMQTTStatus();
+    setInterval(updateMQTTStatus, 5000);
+    return;
+  }
+
+  const events = new EventSource('/events');
+  events.addEventListener('mqtt', e => showMQTTStatus(JSON.parse(e.data)));
+  events.addEventListener('data', e => {
+    const d = JSON.parse(e.data);
+    document.getElementById('live').textContent = `${d.voltage} V  ${d.percent}%  ${d.time}  ${d.state}`;
+  });
+  events.addEventListener('config', e => {
+    const p = JSON.parse(e.data).params || {};
+    if (p.dw) document.getElementById('dw').value = p.dw;
+    if (p.up) document.getElementById('up').value = p.up;
+    if (p.timer) document.getElementById('timer').value = p.timer;
+  });
+}
+
+  function sendCommand(cmd, ev) {
+  if (ev) {
+    ev.preventDefault();
+    ev.stopPropagation();
+  }
+
+return fetch('/send?command=' + encodeURIComponent(cmd))
+  .then(res => res.json())
+  .then(data => {
+    if(data.error) {
+      throw new Error(data.error);
+    }
+    return waitResult(data.id);
+  })
+  .then(data => {
+    const msg = document.createElement('div');
+    msg.innerHTML = `<b>${data.cmd}</b> → <pre>${data.response}</pre>`;
+    document.getElementById('messages').prepend(msg);
+    
+    if (data.cmd === "read" && typeof data.response === "string") {
+      const clean = data.response
+        .replace("dw", "")
+        .replace("up", "")
+        .replace("\n", "")
+        .trim();
+
+      const [dw, up, timer] = clean.split(",");
+
+      if (dw) document.getElementById('dw').value = dw;
+      if (up) document.getElementById('up').value = up;
+      if (timer) document.getElementById('timer').value = timer;
+    }
+
+    
+    if (typeof data.response === "string" && data.response.includes("DOWN")) {
+      sendCommand("read"); 
+    }
+
+    return data;
+  })
+  .catch(err => {
+    const error = document.createElement('div');
+    error.classList.add("danger-text");
+    error.textContent = "" + err;
+    document.getElementById('messages').prepend(error);
+    throw err;
+  });
+  }
+
+// /send only queues the command, poll /result until the UART reply is complete
+function waitResult(id) {
+  return fetch('/result?id=' + id, { credentials: 'include' })
+    .then(res => res.json())
+    .then(data => {
+      if (data.error) {
+        throw new Error(data.error);
+      }
+      if (data.status === "pending") {
+        return new Promise(resolve => setTimeout(resolve, 100)).then(() => waitResult(id));
+      }
+      return data;
+    });
+}
+
+// voltage chart: raw rows are [t,cV,%,state], tier rows are [t,minCv,maxCv,avgCv,min%,max%,avg%]
+function loadHistory() {
+  const tier = document.getElementById('historyTier').value;
+  fetch('/history?tier=' + tier, { credentials: 'include' })
+    .then(r => r.json())
+    .then(data => {
+      const c = document.getElementById('chart');
+      c.width = c.clientWidth;
+      const ctx = c.getContext('2d');
+      ctx.clearRect(0, 0, c.width, c.height);
+      const rows = data.samples || [];
+      if (rows.length < 2) return;
+      const raw = data.tier === "raw";
+      const lo = Math.min(...rows.map(r => r[1]));
+      const hi = Math.max(...rows.map(r => raw ? r[1] : r[2]));
+      const x = i => i * (c.width - 1) / (rows.length - 1);
+      const y = v => c.height - 14 - (v - lo) * (c.height - 28) / Math.max(hi - lo, 1);
+      const line = (col, color) => {
+        ctx.strokeStyle = color;
+        ctx.beginPath();
+        rows.forEach((r, i) => i ? ctx.lineTo(x(i), y(r[col])) : ctx.moveTo(x(i), y(r[col])));
+        ctx.stroke();
+      };
+      if (!raw) { line(1, "#aaa"); line(2, "#aaa"); }
+      line(raw ? 1 : 3, "#e90000");
+      ctx.fillStyle = "#000";
+      ctx.fillText((hi / 100).toFixed(2) + " V", 2, 10);
+      ctx.fillText((lo / 100).toFixed(2) + " V", 2, c.height - 2);
+    });
+}
+
+function confirmResetWifi(event) {
+  if (window.confirm("Are you sure you want to reset wifi credentials?")) {
+    sendCommand('reset_wifi', event)
+  }
+}
+
+window.addEventListener('DOMContentLoaded', () => {
+  connectEvents();
+  sendCommand("read");
+  loadHistory();
+});
+
+  function setDW(ev) {
+    const val = document.getElementById('dw').value;
+    sendCommand("dw" + val, ev);
+  }
+
+  function setUP(ev) {
+    const val = document.getElementById('up').value;
+    sendCommand("up" + val, ev);
+  }
+
+  function setTimer(ev) {
+    const val = document.getElementById('timer').value;
+    sendCommand(val, ev);
+  }
+
+  document.forms.publish.onsubmit = function(ev) {
+    const text = this.message.value;
+    sendCommand(text, ev);
+  };
@@ -7,7 +7,25 @@
 #include <ArduinoJson.h>
 #include <user_interface.h>
 #include <WiFiSetupManager.h>
+#include <LittleFS.h>
 #include "XYParser.h"
+#include "XYUartIngest.h"
+#include "XYCommandQueue.h"
+#include "CommandRegistry.h"
+#include "PublishPolicy.h"
+#include "TelemetryBatcher.h"
+#include "TelemetryEncoding.h"
+#include "TelemetryHistory.h"
+#include "TelemetryOutbox.h"
+#include "TaskScheduler.h"
+#include "StatusLed.h"
+#include "LoopMetrics.h"
+#include "HeapMonitor.h"
+#include "ReconnectBackoff.h"
+#include "TlsResumption.h"
+#include "HeartbeatPolicy.h"
+#include "XYSimulator.h"
+#include "XYChannel.h"
 #include "config.h"
 #include "HttpConfigServer.h"
 #include "EEPROMConfigManager.h"
@@ -15,11 +33,33 @@
 WiFiSetupManager wifiManager("XY-LXXA-Config", IPAddress(192, 168, 1, 1));
 // UART for XY-L10A/XY-L30A
 SoftwareSerial loraSerial(3, 1); // RX = GPIO3, TX = GPIO1
+static_assert(XY_CHANNEL_COUNT >= 1 && XY_CHANNEL_COUNT <= 4, "XY_CHANNEL_COUNT is 1..4");
+static_assert(XY_CHANNEL_COUNT - 1 <= sizeof(XY_CHANNEL_RX_PINS) && XY_CHANNEL_COUNT - 1 <= sizeof(XY_CHANNEL_TX_PINS),
+              "every extra channel needs an RX and a TX pin");
+// one per XY-Lx0A unit, channel 0 is the one on loraSerial/Serial
+XYChannel xyChannels[XY_CHANNEL_COUNT];
+// UARTs of channels 1..n (begin() sets their pins)
+SoftwareSerial xyChannelSerial[XY_CHANNEL_COUNT > 1 ? XY_CHANNEL_COUNT - 1 : 1];
+XYSimulator xySimulators[XY_SIMULATOR ? XY_CHANNEL_COUNT : 1];
+uint8_t telemetryEncoding = DEFAULT_TELEMETRY_ENCODING;
+TelemetryHistory telemetryHistory;
+TelemetryOutbox telemetryOutbox;
+TaskScheduler scheduler;
+StatusLed statusLed;
+LoopMetrics loopMetrics;
+HeapMonitor heapMonitor;
 HttpConfigServer configServer(80, saveConfigToEEPROM, resetWiFiCredentials);
 
 WiFiClientSecure espClient;
 PubSubClient mqttClient(espClient);
+MqttTopics mqttTopics;
+ReconnectBackoff mqttBackoff;
+HeartbeatPolicy heartbeat;
+uint32_t statusSkipped = 0; // device/status payloads that did not fit, not published
 X509List cert(IRG_Root_X1);
+// survives reconnects, so a new handshake can resume instead of a full one
+BearSSL::Session tlsSession;
+TlsStats tlsStats = {};
 
 char WIFI_SSID[64] = {0};
 char WIFI_PASSWORD[64] = {0};
@@ -32,27 +72,43 @@ char authPass[32] = {0};
 
 uint16_t MQTT_PORT = 1883;
 
-unsigned long lastMqttAttempt = 0;
-const unsigned long mqttRetryInterval = 5000; // в мс
 unsigned int WifiattemptReconnect = 0;
 unsigned int MAX_ATTEMPT_TO_RECONNECT = 10; // arter that device will reboot
 
 EEPROMConfigManager eeprom;
+BootTiming bootTiming = {};
+unsigned long lastTlsMs = 0;
+unsigned long lastMqttMs = 0;
 
 void setup()
 {
 
   Serial.begin(115200);
-  delay(1000);
+  if (!FAST_BOOT)
+  {
+    delay(1000);
+  }
 
-  pinMode(LED_BUILTIN, OUTPUT);
+  statusLed.begin(LED_BUILTIN);
   Serial.println(PSTR("=== Let's start ==="));
-  delay(5000);
+  if (!FAST_BOOT)
+  {
+    delay(5000);
+  }
 
+  unsigned long phaseStart = millis();
   eeprom.begin();
+
+  // outbox keeps telemetry on flash while MQTT is down
+  if (!LittleFS.begin() || !telemetryOutbox.begin())
+  {
+    Serial.println(F("⚠️ LittleFS is not available, outbox disabled"));
+  }
   eeprom.loadWiFiConfig(WIFI_SSID, WIFI_PASSWORD);
   loadAuthFromEepromOrUseDefault();
+  bootTiming.eepromMs = millis() - phaseStart;
 
+  phaseStart = millis();
   if (strlen(WIFI_SSID) == 0)
   {
     initLogin();
@@ -61,14 +117,12 @@ void setup()
   {
     connectToAP(WIFI_SSID, WIFI_PASSWORD, true);
   }
+  bootTiming.wifiMs = millis() - phaseStart;
 
-  configServer.setIsSerialDebug(IS_SERIAL_DEBUG);
+  // the simulator needs no UART, so it also works next to Serial Debug
+  configServer.setIsSerialDebug(IS_SERIAL_DEBUG && !XY_SIMULATOR);
 
-  if (!IS_SERIAL_DEBUG)
-  {
-    loraSerial.begin(9600); // UART for XY-L10A/XY-L30A is active if NOT Serial Debug
-    configServer.setLoraSerial(&loraSerial);
-  }
+  setupChannels();
 
   if (WiFi.status() == WL_CONNECTED)
   {
@@ -81,11 +135,26 @@ void setup()
     ESP.restart();
     return;
   }
-  espClient.setTrustAnchors(new X509List(IRG_Root_X1));
-  // espClient.setInsecure(); // (DANGER!!! insecure use it only for tests)
-
   // Load config for
   eeprom.loadMQTTConfig(MQTT_SERVER, &MQTT_PORT, MQTT_USER, MQTT_PASS, MQTT_CLIENT_ID);
+  // the outbox needs topic names before the first connect
+  buildMqttTopics();
+  // chip id and client id, so units with a copied config still spread out
+  mqttBackoff.begin(MQTT_BACKOFF_BASE_MS, MQTT_BACKOFF_CAP_MS, ESP.getChipId() ^ commandHash(MQTT_CLIENT_ID));
+  heartbeat.configure(STATUS_KEEPALIVE_SEC * 1000UL, STATUS_MIN_INTERVAL_MS, STATUS_RSSI_BUCKET_DB);
+  setupTls();
+
+  // telemetry publish policy (deadbands, coalescing window)
+  PublishPolicyConfig policy;
+  eeprom.loadPublishPolicy(policy);
+  for (XYChannel &ch : xyChannels)
+  {
+    ch.policy.setConfig(policy);
+    ch.batcher.configure(policy.batchSize, policy.batchFlushSec);
+  }
+  configServer.setPublishPolicy(policy);
+  configServer.onPublishPolicySave(applyPublishPolicy);
+  telemetryEncoding = eeprom.loadTelemetryEncoding();
 
   // setup MQTTConfig to http server (for edit)
   configServer.setMQTT(
@@ -95,65 +164,329 @@ void setup()
       MQTT_PASS,
       MQTT_CLIENT_ID);
 
+  configServer.setHistory(&telemetryHistory);
+  configServer.setMetrics(&loopMetrics);
+  configServer.onRequest([]()
+                         { debugHeap("http"); });
+  heapMonitor.setThresholds(HEAP_RECONNECT_BLOCK, HEAP_RESTART_BLOCK);
+
   // start the http server
   configServer.begin();
 
+  mqttClient.setBufferSize(MQTT_BUFFER_SIZE);
   mqttClient.setServer(MQTT_SERVER, MQTT_PORT);
   mqttClient.setCallback(callback);
 
   connectMQTT(true);
+  if (mqttClient.connected())
+  {
+    mqttBackoff.succeeded();
+  }
+
+  setupTasks();
 }
 
 void loop()
 {
+  LoopMetrics::Scope scope(loopMetrics, METRIC_LOOP);
+  scheduler.run();
+  loopMetrics.loopTick();
+}
 
-  if (!wifiConnectionCheckAndRenew())
+// everything after setup() is a non-blocking task;
+// budgets (us) are what a task may take before it counts as an overrun
+void setupTasks()
+{
+  if (xyChannels[0].ingest.port())
   {
-    // after bad MAX_ATTEMPT_TO_RECONNECT ESP8266 will restart
-    if (WifiattemptReconnect >= MAX_ATTEMPT_TO_RECONNECT)
-    {
-      delay(2000);
-      ESP.restart();
-    }
+    // UART bytes go to the ring after every task, not only once per loop()
+    scheduler.between([]()
+                      {
+                        for (XYChannel &ch : xyChannels)
+                          ch.ingest.pump(); });
+    scheduler.every("uart", 0, 2000 * XY_CHANNEL_COUNT, []()
+                    {
+                      LoopMetrics::Scope scope(loopMetrics, METRIC_UART);
+                      for (XYChannel &ch : xyChannels)
+                      {
+                        // read data from XY-L10A/XY-L30A UART
+                        loraReader(ch);
+                        // send queued commands, complete the one waiting for a reply
+                        ch.commands.loop();
+                      } });
+  }
 
-    return;
+  scheduler.every("wifi", 5000, 5000, wifiTask);
+  scheduler.every("http", 0, 50000, []()
+                  {
+                    LoopMetrics::Scope scope(loopMetrics, METRIC_HTTP);
+                    configServer.loop(); });
+  scheduler.every("mqtt", 0, 20000, mqttTask);
+  // a TLS handshake always takes longer, so it has no budget
+  scheduler.every("mqtt_conn", 250, 0, mqttConnectTask);
+  scheduler.every("status", 1000, 30000, statusTask);
+  scheduler.every("batch", 1000, 30000, []()
+                  {
+                    for (XYChannel &ch : xyChannels)
+                    {
+                      if (mqttClient.connected() && ch.batcher.due(millis()))
+                      {
+                        flushTelemetryBatch(ch);
+                      }
+                    } });
+  scheduler.every("outbox", 250, 50000, drainOutbox);
+  // publish the sample held by a closed coalescing window
+  // (goes to the outbox while MQTT is down)
+  scheduler.every("policy", 50, 30000, []()
+                  {
+                    XYPacket packet;
+                    for (XYChannel &ch : xyChannels)
+                    {
+                      if (ch.policy.poll(packet, millis()))
+                      {
+                        publishXYPacket(ch, packet);
+                      }
+                    } });
+  scheduler.every("led", 10, 500, []()
+                  { statusLed.tick(); });
+  scheduler.every("heap", 10000, 2000, heapTask);
+
+  if (METRICS_PUBLISH_SEC > 0)
+  {
+    scheduler.every("metrics", METRICS_PUBLISH_SEC * 1000UL, 30000, publishMetrics);
   }
-  else
+}
+
+// reconnect Wi-Fi, after MAX_ATTEMPT_TO_RECONNECT bad attempts ESP8266 will restart
+void wifiTask()
+{
+  static bool restartPending = false;
+
+  if (wifiConnectionCheckAndRenew())
   {
     WifiattemptReconnect = 0; // reset attempt
+    return;
   }
 
-  configServer.loop();
+  if (WifiattemptReconnect >= MAX_ATTEMPT_TO_RECONNECT && !restartPending)
+  {
+    restartPending = true;
+    scheduler.after("restart", 2000, 0, []()
+                    { ESP.restart(); });
+  }
+}
+
+// fragmentation check, acts before the next TLS handshake would fail
+void heapTask()
+{
+  static bool restartPending = false;
+
+  debugHeap("task");
+  HeapAction action = heapMonitor.check(mqttClient.connected());
 
-  if (!IS_SERIAL_DEBUG)
+  if (action == HEAP_RECONNECT && mqttClient.connected())
   {
-    // read data from XY-L10A/XY-L30A UART
-    loraReader();
+    Serial.println(F("⚠️ Heap fragmented, reconnecting MQTT"));
+    mqttClient.disconnect();
+    espClient.stop();
   }
+  else if (action == HEAP_RESTART && !restartPending)
+  {
+    Serial.println(F("⚠️ Heap fragmented, restarting"));
+    restartPending = true;
+    scheduler.after("restart", 1000, 0, []()
+                    { ESP.restart(); });
+  }
+}
 
-  if (!mqttClient.connected())
+// samples heap/stack at a named point, logged in serial debug mode
+void debugHeap(const char *topic)
+{
+  const HeapSample &heap = heapMonitor.sample(topic);
+
+  if (IS_SERIAL_DEBUG)
   {
-    configServer.setMqttConnected(false);
-    connectMQTT(false);
+    Serial.printf_P(PSTR("[heap] %s: free=%u block=%u frag=%u%% stack=%u\n"),
+                    topic, heap.freeHeap, heap.maxBlock, heap.fragmentation, heap.freeStack);
+  }
+}
+
+// reconnect MQTT when the backoff allows it
+void mqttConnectTask()
+{
+  if (mqttClient.connected() || strlen(MQTT_SERVER) == 0 || WiFi.status() != WL_CONNECTED)
+  {
+    return;
+  }
+
+  unsigned long now = millis();
+  if (!mqttBackoff.due(now))
+  {
+    return;
+  }
+
+  connectMQTT(false);
+  if (mqttClient.connected())
+  {
+    mqttBackoff.succeeded();
   }
   else
   {
-    configServer.setMqttConnected(true);
+    mqttBackoff.failed(millis());
+    const ReconnectStats &reconnect = mqttBackoff.stats();
+    configServer.setMqttRetry(reconnect.attempt, reconnect.nextDelayMs);
+    Serial.printf_P(PSTR("MQTT retry %u in %lu ms\n"), reconnect.attempt, (unsigned long)reconnect.nextDelayMs);
+  }
+}
+
+// status on change and as a long keepalive, see HeartbeatPolicy
+void statusTask()
+{
+  HeartbeatReason reason = heartbeat.offer((uint32_t)WiFi.localIP(), WiFi.RSSI(),
+                                           mqttClient.connected(), millis());
+  if (reason != HEARTBEAT_NONE)
+  {
+    publishStatus(reason);
+  }
+}
+
+void mqttTask()
+{
+  bool connected = mqttClient.connected();
+  configServer.setMqttConnected(connected);
+  if (connected)
+  {
+    LoopMetrics::Scope scope(loopMetrics, METRIC_MQTT);
     mqttClient.loop();
-    publishStatus();
   }
 }
 
-// Each 5 sec send the status to MQTT server
-void publishStatus()
+// replay buffered telemetry at a limited rate so live samples are not starved
+// (runs as a 250 ms task)
+void drainOutbox()
 {
-  static unsigned long lastMqttStatusTime = 0;
-  const unsigned long statusInterval = 5000;
+  static const uint16_t recordsPerDrain = 2;
 
-  unsigned long now = millis();
-  if (now - lastMqttStatusTime < statusInterval)
+  if (telemetryOutbox.empty() || !mqttClient.connected())
+  {
     return;
-  lastMqttStatusTime = now;
+  }
+  LoopMetrics::Scope scope(loopMetrics, METRIC_OUTBOX);
+
+  telemetryOutbox.drain([](const char *topic, const uint8_t *payload, size_t len)
+                        { return mqttClient.publish(topic, payload, len); },
+                        recordsPerDrain);
+}
+
+// trust anchor, session cache and (if the broker supports it) small buffers
+void setupTls()
+{
+  if (MQTT_TLS_INSECURE)
+  {
+    espClient.setInsecure();
+  }
+  else
+  {
+    // the global cert, a new X509List here was never freed
+    espClient.setTrustAnchors(&cert);
+  }
+  espClient.setSession(&tlsSession);
+
+  // one extra probe connection at boot; buffers stay at full size if it fails
+  if (TLS_MFLN_SIZE > 0 && strlen(MQTT_SERVER) > 0 &&
+      espClient.probeMaxFragmentLength(MQTT_SERVER, MQTT_PORT, TLS_MFLN_SIZE))
+  {
+    espClient.setBufferSizes(TLS_MFLN_SIZE, TLS_MFLN_SIZE);
+    tlsStats.mfln = TLS_MFLN_SIZE;
+  }
+  // BearSSL RX buffer: record size + 325 bytes of overhead
+  heapMonitor.setHandshakeBlock((tlsStats.mfln ? tlsStats.mfln : 16384) + 325);
+}
+
+// TLS handshake, resumed when the broker still knows the cached session
+bool connectTls()
+{
+  static TlsResumption<BearSSL::Session> resumption;
+  resumption.offer(tlsSession);
+
+  unsigned long start = millis();
+  if (!espClient.connect(MQTT_SERVER, MQTT_PORT))
+  {
+    return false;
+  }
+
+  tlsStats.handshakes++;
+  tlsStats.lastMs = millis() - start;
+  tlsStats.lastResumed = resumption.resumed(tlsSession);
+  if (tlsStats.lastResumed)
+  {
+    tlsStats.resumed++;
+  }
+  return true;
+}
+
+// where the boot time went, once per boot on the first MQTT connect
+void publishBootTiming()
+{
+  if (bootTiming.published)
+  {
+    return;
+  }
+  bootTiming.published = true;
+  bootTiming.tlsMs = lastTlsMs;
+  bootTiming.mqttMs = lastMqttMs;
+  bootTiming.readyMs = millis();
+
+  StaticJsonDocument<256> doc;
+  doc["device_id"] = MQTT_CLIENT_ID;
+  doc["reset_reason"] = ESP.getResetReason();
+  doc["fast_join"] = bootTiming.fastJoin;
+  doc["eeprom_ms"] = bootTiming.eepromMs;
+  doc["wifi_ms"] = bootTiming.wifiMs;
+  doc["tls_ms"] = bootTiming.tlsMs;
+  doc["mqtt_ms"] = bootTiming.mqttMs;
+  doc["ready_ms"] = bootTiming.readyMs;
+
+  char jsonOut[256] = {0};
+  serializeJson(doc, jsonOut, sizeof(jsonOut));
+
+  const char *topic = mqttTopics.get(MQTT_TOPIC_BOOT);
+  mqttClient.publish(topic, jsonOut);
+}
+
+// compact copy of /metrics: per stage [count, avg_us, max_us]
+void publishMetrics()
+{
+  if (!mqttClient.connected())
+    return;
+
+  StaticJsonDocument<640> doc;
+  doc["device_id"] = MQTT_CLIENT_ID;
+  doc["loop_hz"] = loopMetrics.loopHz();
+
+  JsonObject stages = doc.createNestedObject("stages");
+  for (uint8_t i = 0; i < METRIC_STAGE_COUNT; i++)
+  {
+    const LatencyHistogram &h = loopMetrics.histogram((MetricStage)i);
+    JsonArray row = stages.createNestedArray(LoopMetrics::stageName((MetricStage)i));
+    row.add(h.count);
+    row.add(h.count ? (uint32_t)(h.sumUs / h.count) : 0);
+    row.add(h.maxUs);
+  }
+
+  char jsonOut[512] = {0};
+  serializeJson(doc, jsonOut, sizeof(jsonOut));
+
+  const char *topic = mqttTopics.get(MQTT_TOPIC_METRICS);
+  mqttClient.publish(topic, jsonOut);
+}
+
+// send the status to MQTT server, on connect and when statusTask() decides to
+void publishStatus(HeartbeatReason reason)
+{
+  if (!mqttClient.connected())
+    return;
+  LoopMetrics::Scope scope(loopMetrics, METRIC_STATUS);
 
   // create uptime
   unsigned long uptimeSec = millis() / 1000;
@@ -170,17 +503,137 @@ void publishStatus()
   snprintf_P(ipStr, sizeof(ipStr), PSTR("%u.%u.%u.%u"),
              ip[0], ip[1], ip[2], ip[3]);
 
-  StaticJsonDocument<192> doc;
+  const XYUartStats &uart = xyChannels[0].ingest.stats();
+
+  if (telemetryEncoding & ENC_STATUS_BIN)
+  {
+    StatusSample status;
+    status.online = true;
+    status.ip = (uint32_t)ip[0] << 24 | (uint32_t)ip[1] << 16 | ip[2] << 8 | ip[3];
+    status.rssi = WiFi.RSSI();
+    status.uptimeSec = uptimeSec;
+    status.uartBps = uart.bytesPerSec;
+    status.uartOverruns = uart.overruns;
+    uint8_t payload[32];
+    size_t len = TelemetryEncoder::encodeStatus(status, payload, sizeof(payload));
+    publishBinary(mqttTopics.get(MQTT_TOPIC_STATUS_BIN), payload, len);
+  }
+
+  if (!(telemetryEncoding & ENC_STATUS_JSON))
+  {
+    return;
+  }
+
+  // static: off the 4 KB cont stack, this also runs inside connectMQTT
+  static StaticJsonDocument<1152> doc;
+  doc.clear();
   doc["status"] = "online";
   doc["ip"] = ipStr;
   doc["rssi"] = WiFi.RSSI();
   doc["uptime"] = uptimeStr;
   doc["device_id"] = MQTT_CLIENT_ID;
+  doc["reason"] = HeartbeatPolicy::reasonName(reason);
+
+  // MQTT reconnect backoff
+  const ReconnectStats &reconnect = mqttBackoff.stats();
+  JsonObject mqttObj = doc.createNestedObject("mqtt");
+  mqttObj["connects"] = reconnect.connects;
+  mqttObj["failures"] = reconnect.failures;
+  mqttObj["retries"] = reconnect.lastRetries;
+  mqttObj["heartbeats"] = heartbeat.published();
+  mqttObj["status_skipped"] = statusSkipped;
+
+  // XY-L30A UART ingestion counters
+  JsonObject uartObj = doc.createNestedObject("uart");
+  uartObj["bps"] = uart.bytesPerSec;
+  uartObj["lines"] = uart.lines;
+  uartObj["overruns"] = uart.overruns;
+  uartObj["truncated"] = uart.truncatedLines;
+  uartObj["garbled"] = uart.garbledLines;
+  uartObj["decode_ns"] = loopMetrics.decodeNsPerLine();
+
+  if (XY_SIMULATOR)
+  {
+    JsonObject simObj = uartObj.createNestedObject("sim");
+    const XYSimulatorStats &sim = xySimulators[0].stats();
+    simObj["lines"] = sim.lines;
+    simObj["commands"] = sim.commands;
+    simObj["overruns"] = sim.overruns;
+    simObj["damaged"] = sim.damaged;
+  }
 
-  char jsonOut[128] = {0};
+  // the other units of a multi-channel bridge: [lines, overruns, garbled]
+  if (XY_CHANNEL_COUNT > 1)
+  {
+    JsonObject unitsObj = doc.createNestedObject("units");
+    for (uint8_t i = 1; i < XY_CHANNEL_COUNT; i++)
+    {
+      const XYUartStats &unit = xyChannels[i].ingest.stats();
+      JsonArray row = unitsObj.createNestedArray(xyChannels[i].unit);
+      row.add(unit.lines);
+      row.add(unit.overruns);
+      row.add(unit.garbledLines);
+    }
+  }
+
+  // store-and-forward counters (since boot)
+  JsonObject outboxObj = doc.createNestedObject("outbox");
+  outboxObj["segments"] = telemetryOutbox.segments();
+  outboxObj["stored"] = telemetryOutbox.stored();
+  outboxObj["replayed"] = telemetryOutbox.replayed();
+  outboxObj["dropped"] = telemetryOutbox.dropped();
+
+  // MQTT TLS handshakes
+  JsonObject tlsObj = doc.createNestedObject("tls");
+  tlsObj["handshake_ms"] = tlsStats.lastMs;
+  tlsObj["resumed"] = tlsStats.lastResumed;
+  tlsObj["handshakes"] = tlsStats.handshakes;
+  tlsObj["resumes"] = tlsStats.resumed;
+  tlsObj["mfln"] = tlsStats.mfln;
+
+  // heap now and worst since boot
+  const HeapSample &heap = heapMonitor.last();
+  const HeapSample &worst = heapMonitor.worst();
+  JsonObject heapObj = doc.createNestedObject("heap");
+  heapObj["free"] = heap.freeHeap;
+  heapObj["max_block"] = heap.maxBlock;
+  heapObj["frag"] = heap.fragmentation;
+  heapObj["min_free"] = worst.freeHeap;
+  heapObj["min_block"] = worst.maxBlock;
+  heapObj["min_block_at"] = heapMonitor.worstPoint();
+  heapObj["max_frag"] = worst.fragmentation;
+  heapObj["min_stack"] = worst.freeStack;
+  heapObj["reconnects"] = heapMonitor.reconnects();
+
+  // task scheduler: total overruns and the slowest task
+  JsonObject schedObj = doc.createNestedObject("sched");
+  schedObj["overruns"] = scheduler.overruns();
+  const SchedulerTask *slowest = nullptr;
+  for (uint8_t i = 0; i < TaskScheduler::MAX_TASKS; i++)
+  {
+    const SchedulerTask *t = scheduler.task(i);
+    if (t && (!slowest || t->maxUs > slowest->maxUs))
+      slowest = t;
+  }
+  if (slowest)
+  {
+    schedObj["slowest"] = slowest->name;
+    schedObj["max_us"] = slowest->maxUs;
+  }
+
+  // a cut payload would be invalid JSON, and it would be retained
+  static char jsonOut[MQTT_BUFFER_SIZE - 64];
+  size_t len = measureJson(doc);
+  if (doc.overflowed() || len >= sizeof(jsonOut))
+  {
+    statusSkipped++;
+    Serial.printf_P(PSTR("⚠️ status not published, %u bytes\n"), (unsigned)len);
+    return;
+  }
   serializeJson(doc, jsonOut, sizeof(jsonOut));
 
-  mqttClient.publish("device/status", jsonOut, MQTT_RETAIN);
+  mqttClient.publish(mqttTopics.get(MQTT_TOPIC_STATUS), jsonOut, MQTT_RETAIN);
+  debugHeap("publish");
 }
 
 // reset wifi ssid and wifi password
@@ -197,33 +650,22 @@ void resetWiFiCredentials()
   ESP.restart();
 }
 
+// non-blocking, the "led" task plays the pattern
 void blink(int _delay = 500, int num = 1)
 {
-  for (int i = 0; i < num; i++)
-  {
-    digitalWrite(LED_BUILTIN, LOW); // Turn on (LOW — active level for ESP)
-    delay(_delay);
-    digitalWrite(LED_BUILTIN, HIGH); // Turn oof
-    delay(_delay);
-  }
+  statusLed.blink(_delay, num);
 }
 
 // check the wifi connection if it is lose function will try to reconnect
+// (called every 5 sec by the "wifi" task)
 bool wifiConnectionCheckAndRenew()
 {
-  static unsigned long lastWiFiRetry = 0;
-  const unsigned long wifiRetryInterval = 5000;
-
   if (WiFi.status() != WL_CONNECTED)
   {
-    unsigned long _now = millis();
-    if (_now - lastWiFiRetry > wifiRetryInterval)
-    {
-      // Wi-Fi is lose try to reconnect
-      WiFi.reconnect();
-      lastWiFiRetry = _now;
-      blink(50);
-    }
+    // Wi-Fi is lose try to reconnect
+    WiFi.reconnect();
+    WifiattemptReconnect++;
+    blink(50);
     return false;
   }
 
@@ -249,6 +691,7 @@ void initLogin()
       {
         // if data (SSID & password) is correct. then save it to eeprom
         eeprom.saveWiFiConfig(config.SSID, config.password);
+        eeprom.commit();
         Serial.println("Wi-Fi saved!");
         break;
       }
@@ -271,8 +714,7 @@ void connectToAP(const char *ssid, const char *pass, bool isCheckAttempt = false
   {
     return;
   }
-  int tryCount = 0;
-  int ATTEMPT = 1000; // each ATTEMPT == 1000ms
+  unsigned long ATTEMPT_TIMEOUT = 1000000UL; // ms, same 1000 x 1s as before
 
   // Отримуємо MAC-адресу
   uint8_t mac[6];       // MAC (6 bytes)
@@ -282,50 +724,111 @@ void connectToAP(const char *ssid, const char *pass, bool isCheckAttempt = false
   // format to XX:XX:XX:XX:XX:XX
   Serial.printf("%02X:%02X:%02X:%02X:%02X:%02X\n", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
 
-
-
   // Connect to Wi-Fi
   WiFi.mode(WIFI_STA);
   WiFi.hostname(WIFI_HOSTNAME);
-  WiFi.begin(ssid, pass);
 
-  while (true)
+  // the join cache belongs to the saved network only
+  bool isSavedNetwork = strcmp(ssid, WIFI_SSID) == 0;
+  bootTiming.fastJoin = FAST_BOOT && isSavedNetwork && fastJoin(ssid, pass);
+
+  if (!bootTiming.fastJoin)
   {
-    wl_status_t status = WiFi.status();
-    if (status == WL_CONNECTED)
-    {
+    WiFi.begin(ssid, pass);
 
-      break;
-    }
-    blink(50);
-    Serial.print('.');
-    if (isCheckAttempt)
+    unsigned long start = millis();
+    unsigned long lastBlink = 0;
+    while (true)
     {
-      tryCount++;
-      if (status == WL_CONNECT_FAILED || tryCount >= ATTEMPT)
+      wl_status_t status = WiFi.status();
+      if (status == WL_CONNECTED)
+      {
+        break;
+      }
+      if (millis() - lastBlink >= 1000)
+      {
+        lastBlink = millis();
+        blink(50);
+        Serial.print('.');
+      }
+      // the scheduler is not running yet
+      statusLed.tick();
+      if (isCheckAttempt && (status == WL_CONNECT_FAILED || millis() - start >= ATTEMPT_TIMEOUT))
       {
         return;
       }
+      delay(100);
     }
-    delay(1000);
   }
+
   Serial.println("IP address: ");
   Serial.println(WiFi.localIP());
-  // get correct time
+
+  if (FAST_BOOT && isSavedNetwork)
+  {
+    cacheWiFiJoin();
+  }
+
+  // get correct time in the background, time(nullptr) is valid once NTP answers
   configTime(3 * 3600, 0, "pool.ntp.org", "time.nist.gov");
+}
 
-  time_t now = time(nullptr);
-  while (now < 8 * 3600 * 2)
+// join the cached BSSID/channel without a scan
+bool fastJoin(const char *ssid, const char *pass)
+{
+  WiFiJoinCache cache;
+  if (!eeprom.loadWiFiJoinCache(cache))
   {
-    delay(500);
-    Serial.print(".");
-    now = time(nullptr);
+    return false;
+  }
+
+  if (FAST_BOOT_STATIC_IP && cache.ip)
+  {
+    WiFi.config(IPAddress(cache.ip), IPAddress(cache.gateway),
+                IPAddress(cache.subnet), IPAddress(cache.dns));
+  }
+  WiFi.begin(ssid, pass, cache.channel, cache.bssid);
+
+  unsigned long start = millis();
+  while (millis() - start < FAST_JOIN_TIMEOUT_MS)
+  {
+    if (WiFi.status() == WL_CONNECTED)
+    {
+      return true;
+    }
+    delay(20);
+  }
+
+  // stale cache (AP moved, new lease): back to DHCP and a full scan
+  Serial.println(F("Fast join failed, scanning..."));
+  WiFi.disconnect();
+  if (FAST_BOOT_STATIC_IP)
+  {
+    WiFi.config(0u, 0u, 0u);
   }
+  return false;
+}
 
-  struct tm timeinfo;
-  gmtime_r(&now, &timeinfo);
-  Serial.println(asctime(&timeinfo));
+// remember the current join, flash is written only when it changed
+void cacheWiFiJoin()
+{
+  WiFiJoinCache cache = {};
+  memcpy(cache.bssid, WiFi.BSSID(), sizeof(cache.bssid));
+  cache.channel = WiFi.channel();
+  cache.ip = WiFi.localIP();
+  cache.gateway = WiFi.gatewayIP();
+  cache.subnet = WiFi.subnetMask();
+  cache.dns = WiFi.dnsIP();
+
+  WiFiJoinCache saved;
+  eeprom.loadWiFiJoinCache(saved);
+  if (memcmp(&saved, &cache, sizeof(cache)) == 0)
+  {
+    return;
+  }
 
+  eeprom.saveWiFiJoinCache(cache);
+  eeprom.commit();
 }
 
 void loadAuthFromEepromOrUseDefault()
@@ -353,24 +856,48 @@ void saveConfigToEEPROM(const char *mqtt_ip, const char *mqtt_port,
   uint16_t port = atoi(mqtt_port);
   eeprom.saveMQTTConfig(mqtt_ip, port, user, mqtt_pass, client_id);
   eeprom.saveAuth(auth_user, auth_pass);
+  // one flash write for the whole settings form
+  eeprom.commit();
 }
 
-void connectMQTT(bool force = false)
+// applies the policy and stages it in the config record (eeprom.commit() writes it)
+// (one policy for every unit)
+void applyPublishPolicy(const PublishPolicyConfig &cfg)
 {
+  for (XYChannel &ch : xyChannels)
+  {
+    ch.policy.setConfig(cfg);
+    // a pending frame goes out with the old batch size
+    flushTelemetryBatch(ch);
+    ch.batcher.configure(cfg.batchSize, cfg.batchFlushSec);
+  }
+  eeprom.savePublishPolicy(cfg);
+}
 
-  char willTopic[32];
-  char commandTopic[32];
-  strncpy_P(willTopic, STATUS_TOPIC, sizeof(willTopic));
-  strncpy_P(commandTopic, COMMAND_TOPIC, sizeof(commandTopic));
+// every topic name once, instead of on every publish
+void buildMqttTopics()
+{
+  static const char *const FLAT_TOPICS[MQTT_TOPIC_COUNT] = {
+      COMMAND_TOPIC, COMMAND_REPLY_TOPIC, STATUS_TOPIC, STATUS_BIN_TOPIC, BOOT_TOPIC, METRICS_TOPIC,
+      TOPIC_XY_DATA, TOPIC_XY_DATA_BATCH, TOPIC_XY_DATA_BIN, TOPIC_XY_CONFIG, TOPIC_XY_RAW, TOPIC_XY_REPLY};
+
+  if (!mqttTopics.build(MQTT_CLIENT_ID, MQTT_TOPIC_PREFIX, FLAT_TOPICS, MQTT_FLAT_TOPICS))
+  {
+    Serial.println(F("⚠️ Client id too long for per-device topics, using flat topics"));
+  }
+}
 
-  if (!force && (strlen(MQTT_SERVER) == 0 ||
-                 WiFi.status() != WL_CONNECTED ||
-                 millis() - lastMqttAttempt < mqttRetryInterval))
+void connectMQTT(bool force = false)
+{
+  // retries are paced by the "mqtt_conn" task
+  if (!force && (mqttClient.connected() ||
+                 strlen(MQTT_SERVER) == 0 ||
+                 WiFi.status() != WL_CONNECTED))
   {
     return;
   }
+  LoopMetrics::Scope scope(loopMetrics, METRIC_MQTT_CONNECT);
 
-  lastMqttAttempt = millis();
   Serial.println(F("MQTT connect..."));
   blink(100, 3);
 
@@ -381,20 +908,44 @@ void connectMQTT(bool force = false)
              OFFLINE_STATUS,
              MQTT_CLIENT_ID);
 
+  // the client id may have changed in the settings
+  buildMqttTopics();
+
+  // TLS first (PubSubClient reuses an open connection), so both phases are timed
+  unsigned long phaseStart = millis();
+  bool tlsConnected = espClient.connected() || connectTls();
+  lastTlsMs = millis() - phaseStart;
+  debugHeap("tls");
+
   // connect to Mqtt
-  if (mqttClient.connect(
-          MQTT_CLIENT_ID,
+  phaseStart = millis();
+  if (tlsConnected && mqttClient.connect(
+                          MQTT_CLIENT_ID,
           MQTT_USER,
           MQTT_PASS,
-          willTopic,
+          mqttTopics.get(MQTT_TOPIC_STATUS),
           MQTT_QOS,
           MQTT_RETAIN,
           willPayload))
   {
     // MQTT Connected is connected
     configServer.setMqttConnected(true);
+    // first sample after (re)connect is always published
+    for (XYChannel &ch : xyChannels)
+    {
+      ch.policy.reset();
+    }
     // subscribe to topic
-    mqttClient.subscribe(commandTopic);
+    mqttClient.subscribe(mqttTopics.get(MQTT_TOPIC_CMD));
+    if (strlen(MQTT_GROUP_TOPIC) > 0)
+    {
+      mqttClient.subscribe(MQTT_GROUP_TOPIC);
+    }
+
+    lastMqttMs = millis() - phaseStart;
+    // replaces the retained Last Will at once, not on the next status tick
+    publishStatus(heartbeat.connected((uint32_t)WiFi.localIP(), WiFi.RSSI(), millis()));
+    publishBootTiming();
   }
   else
   {
@@ -405,14 +956,116 @@ void connectMQTT(bool force = false)
   }
 }
 
+// MQTT command handlers, the value is already checked against COMMANDS
+
+CommandStatus cmdRestart(const CommandArg &, JsonObject result)
+{
+  // later, so the reply still goes out
+  if (scheduler.after("restart", 500, 0, []()
+                      { ESP.restart(); }) == TaskScheduler::NO_TASK)
+  {
+    result["error"] = "scheduler full";
+    return CMD_FAILED;
+  }
+  return CMD_OK;
+}
+
+CommandStatus cmdBlink(const CommandArg &arg, JsonObject)
+{
+  blink(200, arg.num);
+  return CMD_OK;
+}
+
+CommandStatus cmdUartSend(const CommandArg &arg, JsonObject result)
+{
+  XYChannel *ch = findChannel(arg.unit);
+  if (!ch)
+  {
+    result["error"] = "unknown unit";
+    return CMD_BAD_ARG;
+  }
+  if (ch->named())
+  {
+    result["unit"] = ch->unit;
+  }
+
+  // the module's reply is published on the reply topic by onXYCommandComplete
+  uint16_t id = ch->commands.enqueue(arg.str, XY_CMD_MQTT, arg.id);
+  if (id == 0)
+  {
+    result["error"] = "queue full";
+    return CMD_FAILED;
+  }
+  result["cmd_id"] = id;
+  return CMD_ACCEPTED;
+}
+
+CommandStatus cmdResetWiFi(const CommandArg &, JsonObject result)
+{
+  if (scheduler.after("reset_wifi", 500, 0, resetWiFiCredentials) == TaskScheduler::NO_TASK)
+  {
+    result["error"] = "scheduler full";
+    return CMD_FAILED;
+  }
+  return CMD_OK;
+}
+
+CommandStatus cmdEncoding(const CommandArg &arg, JsonObject)
+{
+  // value: "data=json|bin|both,status=json|bin|both" (any subset)
+  if (!TelemetryEncoder::parseConfig(arg.str, telemetryEncoding))
+  {
+    return CMD_BAD_ARG;
+  }
+  eeprom.saveTelemetryEncoding(telemetryEncoding);
+  eeprom.commit();
+  return CMD_OK;
+}
+
+CommandStatus cmdPublishPolicy(const CommandArg &arg, JsonObject)
+{
+  // value: "dv=5,dp=1,silence=60,window=1000" (any subset)
+  PublishPolicyConfig policy = xyChannels[0].policy.config();
+  if (!PublishPolicy::parseConfig(arg.str, policy))
+  {
+    return CMD_BAD_ARG;
+  }
+  applyPublishPolicy(policy);
+  eeprom.commit();
+  configServer.setPublishPolicy(policy);
+  return CMD_OK;
+}
+
+constexpr CommandSpec COMMANDS[] = {
+    {"restart", CMD_ARG_NONE, 0, 0, cmdRestart},
+    {"blink", CMD_ARG_UINT, 1, 20, cmdBlink},
+    {"uart_send", CMD_ARG_STRING, 0, sizeof(XYCommand::command) - 1, cmdUartSend},
+    {"reset_wifi", CMD_ARG_NONE, 0, 0, cmdResetWiFi},
+    {"encoding", CMD_ARG_STRING, 0, 64, cmdEncoding},
+    {"publish_policy", CMD_ARG_STRING, 0, 64, cmdPublishPolicy},
+};
+constexpr uint8_t COMMAND_COUNT = sizeof(COMMANDS) / sizeof(COMMANDS[0]);
+static_assert(commandHashesUnique(COMMANDS, COMMAND_COUNT), "two MQTT actions share a hash");
+
+const CommandRegistry commandRegistry(COMMANDS, COMMAND_COUNT);
+
 void callback(char *topic, byte *payload, unsigned int length)
 {
   char logBuffer[128];
   char formatBuffer[64];
 
-  // 1. JSON parse
-  StaticJsonDocument<200> doc;
-  DeserializationError error = deserializeJson(doc, payload, length);
+  // the flat command topic carries the whole fleet's commands: skip the
+  // parse unless our client id is somewhere in the payload
+  bool shared = mqttTopics.flat() && strcmp(topic, mqttTopics.get(MQTT_TOPIC_CMD)) == 0;
+  if (shared && !memmem(payload, length, MQTT_CLIENT_ID, strlen(MQTT_CLIENT_ID)))
+  {
+    return;
+  }
+
+  // 1. JSON parse; the strings are copied (at most the payload size), as a
+  //    handler that publishes overwrites PubSubClient's buffer mid-batch
+  static StaticJsonDocument<1024 + MQTT_BUFFER_SIZE> doc;
+  DeserializationError error = CommandRegistry::parse(doc, payload, length);
 
   if (error)
   {
@@ -422,184 +1075,403 @@ void callback(char *topic, byte *payload, unsigned int length)
     return;
   }
 
-  // 2. data extract
-  const char *action = doc["action"];
-  const char *value = doc["value"];
+  // 2. check device_id (required on the flat topic, optional on our own
+  //    and the group topic)
   const char *device_id = doc["receiver"];
-
-  // 3. check device_id
   strncpy_P(formatBuffer, MSG_DEVICE_ID, sizeof(formatBuffer));
   snprintf(logBuffer, sizeof(logBuffer), formatBuffer,
            device_id ? device_id : "null", MQTT_CLIENT_ID);
   Serial.println(logBuffer);
 
-  if (device_id && strcmp(device_id, MQTT_CLIENT_ID) == 0)
+  if (device_id ? strcmp(device_id, MQTT_CLIENT_ID) != 0 : shared)
+  {
+    return;
+  }
+
+  // 3. run the command(s) in order, one result each
+  static StaticJsonDocument<1024> reply;
+  reply.clear();
+  reply["device_id"] = MQTT_CLIENT_ID;
+  JsonArray results = reply.createNestedArray("results");
+  commandRegistry.dispatch(doc.as<JsonVariantConst>(), results);
+
+  // 4. log and acknowledge
+  strncpy_P(formatBuffer, MSG_MQTT_CMD, sizeof(formatBuffer));
+  for (JsonObject result : results)
   {
-    // 4. log command
-    strncpy_P(formatBuffer, MSG_MQTT_CMD, sizeof(formatBuffer));
+    const char *action = result["action"];
     snprintf(logBuffer, sizeof(logBuffer), formatBuffer,
-             action ? action : "null", value ? value : "null");
+             action ? action : "null", (const char *)result["status"]);
     Serial.println(logBuffer);
+  }
+
+  static char jsonOut[768];
+  serializeJson(reply, jsonOut, sizeof(jsonOut));
+
+  const char *replyTopic = mqttTopics.get(MQTT_TOPIC_CMD_REPLY);
+  mqttClient.publish(replyTopic, jsonOut);
+}
+
+// channel 0 is the configured UART, channel n a SoftwareSerial on its own
+// pins; with XY_SIMULATOR every channel gets a simulator instead
+void setupChannels()
+{
+  for (uint8_t i = 0; i < XY_CHANNEL_COUNT; i++)
+  {
+    XYChannel &ch = xyChannels[i];
+    // a single unit keeps its topics and payloads as they were
+    if (XY_CHANNEL_COUNT > 1)
+    {
+      ch.unit = XY_CHANNEL_UNITS[i];
+    }
+
+    if (XY_SIMULATOR)
+    {
+      XYSimulator &simulator = xySimulators[i];
+      simulator.begin(XY_SIMULATOR_INTERVAL_MS, XY_SIMULATOR_SPEEDUP);
+      // own seed, so the units are not damaged in lockstep
+      simulator.setNoise(XY_SIMULATOR_NOISE, ESP.getChipId() + i);
+      // the trace is replayed on the first unit only
+      if (i == 0 && simulator.replay(LittleFS, XY_SIMULATOR_TRACE))
+      {
+        Serial.println(F("XY simulator: replaying " XY_SIMULATOR_TRACE));
+      }
+      ch.ingest.begin(&simulator);
+    }
+    else if (IS_SERIAL_DEBUG)
+    {
+      // UART for XY-L10A/XY-L30A is active if NOT Serial Debug
+      return;
+    }
+    else if (i > 0)
+    {
+      SoftwareSerial &serial = xyChannelSerial[i - 1];
+      serial.begin(XY_UART_BAUD, SWSERIAL_8N1, XY_CHANNEL_RX_PINS[i - 1], XY_CHANNEL_TX_PINS[i - 1]);
+      ch.ingest.begin(&serial);
+    }
+    else if (XY_UART_HARDWARE)
+    {
+      Serial.flush();
+      Serial.setRxBufferSize(256); // must be set before begin()
+      Serial.begin(XY_UART_BAUD);
+      if (XY_UART_SWAP_PINS)
+      {
+        Serial.swap(); // RX = GPIO13, TX = GPIO15
+      }
+      ch.ingest.begin(&Serial);
+    }
+    else
+    {
+      loraSerial.begin(XY_UART_BAUD);
+      ch.ingest.begin(&loraSerial);
+    }
 
-    // 5. handle command
-    handleMQTTCommand(action, value);
+    ch.commands.begin(ch.ingest.port());
+    ch.commands.onComplete([&ch](const XYCommand &cmd)
+                           { onXYCommandComplete(ch, cmd); });
+    configServer.addCommandQueue(&ch.commands, ch.unit);
   }
 }
 
-void handleMQTTCommand(const char *action, const char *value)
+// the channel a command is addressed to, the first one without a unit
+XYChannel *findChannel(const char *unit)
 {
-  if (!action)
-    return;
+  if (!unit || !unit[0])
+  {
+    return &xyChannels[0];
+  }
 
-  char logBuffer[64];
+  for (XYChannel &ch : xyChannels)
+  {
+    if (ch.named() && strcmp(ch.unit, unit) == 0)
+    {
+      return &ch;
+    }
+  }
+  return nullptr;
+}
 
-  if (strcmp(action, "restart") == 0)
+// "<topic>/<unit>" for the units of a multi-channel bridge, the topic itself otherwise
+const char *unitTopic(MqttTopic topic, const XYChannel &ch, char *buf, size_t size)
+{
+  if (!ch.named())
   {
-    ESP.restart();
+    return mqttTopics.get(topic);
   }
-  else if (strcmp(action, "blink") == 0 && value)
+
+  snprintf(buf, size, "%s/%s", mqttTopics.get(topic), ch.unit);
+  return buf;
+}
+
+void loraReader(XYChannel &ch)
+{
+  static const uint8_t MAX_LINES_PER_LOOP = 8;
+  char line[XYUartIngest::LINE_SIZE];
+
+  ch.ingest.pump();
+
+  // drain complete lines in a bounded batch, the rest waits for the next loop()
+  for (uint8_t i = 0; i < MAX_LINES_PER_LOOP; ++i)
   {
-    blink(200, atoi(value));
+    if (ch.ingest.readLine(line, sizeof(line)) == 0)
+      break;
+    handleXYResponse(ch, line);
   }
-  else if (strcmp(action, "uart_send") == 0 && value)
+}
+
+// publish the reply of a uart_send command to whoever sent it over MQTT
+// (HTTP replies stay in the queue until /result picks them up)
+void onXYCommandComplete(const XYChannel &ch, const XYCommand &cmd)
+{
+  if (cmd.origin != XY_CMD_MQTT || !mqttClient.connected())
   {
-    loraSerial.print(value);
+    return;
   }
-  else if (strcmp(action, "reset_wifi") == 0)
+
+  StaticJsonDocument<320> doc;
+  doc["type"] = "reply";
+  doc["id"] = cmd.id;
+  doc["cmd"] = cmd.command;
+  doc["status"] = cmd.state == XY_CMD_TIMEOUT ? "timeout" : "done";
+  doc["response"] = cmd.response;
+  if (cmd.ref[0])
   {
-    resetWiFiCredentials();
+    doc["ref"] = cmd.ref;
   }
-  else
+  doc["device_id"] = MQTT_CLIENT_ID;
+  if (ch.named())
   {
-    strncpy_P(logBuffer, MSG_UNKNOWN_CMD, sizeof(logBuffer));
-    snprintf(logBuffer, sizeof(logBuffer), logBuffer, action);
-    Serial.println(logBuffer);
+    doc["unit"] = ch.unit;
   }
+
+  char jsonOut[384] = {0};
+  serializeJson(doc, jsonOut, sizeof(jsonOut));
+
+  char topicBuf[MqttTopics::MAX_TOPIC_SIZE];
+  const char *topic = unitTopic(MQTT_TOPIC_REPLY, ch, topicBuf, sizeof(topicBuf));
+  mqttClient.publish(topic, jsonOut);
 }
 
-void loraReader()
+// publish collected samples as one esp/data/batch frame
+void flushTelemetryBatch(XYChannel &ch)
 {
-  static char loraBuffer[64];
-  static byte index = 0;
+  if (ch.batcher.count() == 0 || !mqttClient.connected())
+  {
+    return;
+  }
 
-  while (loraSerial.available())
+  static char frame[MQTT_BUFFER_SIZE - 64];
+  size_t len = ch.batcher.serialize(frame, sizeof(frame), MQTT_CLIENT_ID, ch.unit);
+
+  char topicBuf[MqttTopics::MAX_TOPIC_SIZE];
+  const char *topic = unitTopic(MQTT_TOPIC_DATA_BATCH, ch, topicBuf, sizeof(topicBuf));
+  if (len > 0)
   {
-    char c = loraSerial.read();
-    if (c == '\n')
-    {
-      loraBuffer[index] = '\0';
-      if (index > 0)
-        handleXYResponse(loraBuffer);
-      index = 0;
-    }
-    else if (index < sizeof(loraBuffer) - 1)
-    {
-      loraBuffer[index++] = c;
-    }
-    else
-    {
-      index = 0;
-    }
-    yield();
+    mqttClient.publish(topic, (const uint8_t *)frame, len);
+    debugHeap("publish");
+  }
+  ch.batcher.clear();
+}
+
+// MessagePack payload, see TelemetryEncoding.h
+void publishBinary(const char *topic, const uint8_t *payload, size_t len)
+{
+  if (len == 0)
+  {
+    return;
   }
+
+  mqttClient.publish(topic, payload, len);
 }
 
-void handleXYResponse(const char *rawLine)
+void publishXYPacket(XYChannel &ch, const XYPacket &packet)
 {
+  char topicBuf[MqttTopics::MAX_TOPIC_SIZE];
 
   if (!mqttClient.connected())
   {
+    // store-and-forward in the configured encodings, replayed by drainOutbox() after reconnect
+    if (telemetryEncoding & ENC_DATA_BIN)
+    {
+      uint8_t payload[24];
+      size_t len = TelemetryEncoder::encodeData(packet, payload, sizeof(payload));
+      telemetryOutbox.appendBinary(unitTopic(MQTT_TOPIC_DATA_BIN, ch, topicBuf, sizeof(topicBuf)), payload, len);
+    }
+    if (telemetryEncoding & ENC_DATA_JSON)
+    {
+      char jsonBuffer[256] = {0};
+      buildXYPacketJson(packet, time(nullptr), ch.unit, jsonBuffer, sizeof(jsonBuffer));
+      telemetryOutbox.append(unitTopic(MQTT_TOPIC_DATA, ch, topicBuf, sizeof(topicBuf)), jsonBuffer);
+    }
     return;
   }
 
-  char jsonBuffer[256] = {0};
-  char JsonTypeData[] = "data";
-  char JsonTypeConfig[] = "config";
-  char JsonTypeRaw[] = "raw";
+  // coalesced samples include their time in the window, batched ones not the batch wait
+  loopMetrics.recordUs(METRIC_LINE_TO_PUBLISH, micros() - ch.lastDataLineUs);
 
-  XYPacket packet;
+  if (telemetryEncoding & ENC_DATA_BIN)
+  {
+    uint8_t payload[24];
+    size_t len = TelemetryEncoder::encodeData(packet, payload, sizeof(payload));
+    publishBinary(unitTopic(MQTT_TOPIC_DATA_BIN, ch, topicBuf, sizeof(topicBuf)), payload, len);
+  }
 
-  // data parsing
-  if (XYParser::parse(rawLine, packet))
+  if (!(telemetryEncoding & ENC_DATA_JSON))
   {
+    return;
+  }
 
-    char timeStr[6] = {0};
-    snprintf(timeStr, sizeof(timeStr), "%02d:%02d", packet.hours, packet.minutes);
+  if (ch.batcher.enabled())
+  {
+    // full batch or state change: flush at once
+    if (ch.batcher.add(packet, millis()))
+    {
+      flushTelemetryBatch(ch);
+    }
+    return;
+  }
 
-    StaticJsonDocument<192> doc;
-    doc["type"] = JsonTypeData;
-    doc["voltage"] = packet.voltage;
-    doc["percent"] = packet.percent;
-    doc["time"] = timeStr;
-    doc["state"] = packet.state;
-    doc["device_id"] = MQTT_CLIENT_ID;
+  char jsonBuffer[256] = {0};
+  buildXYPacketJson(packet, 0, ch.unit, jsonBuffer, sizeof(jsonBuffer));
 
-    serializeJson(doc, jsonBuffer, sizeof(jsonBuffer));
+  const char *topic = unitTopic(MQTT_TOPIC_DATA, ch, topicBuf, sizeof(topicBuf));
+  mqttClient.publish(topic, jsonBuffer);
+  debugHeap("publish");
+}
 
-    char topic[32];
-    strncpy_P(topic, TOPIC_XY_DATA, sizeof(topic));
-    mqttClient.publish(topic, jsonBuffer);
+// esp/data JSON, `ts` (unix time of the sample) is added for buffered samples
+// (`"ts_valid":false` if NTP had not answered yet),
+// `unit` for the units of a multi-channel bridge
+size_t buildXYPacketJson(const XYPacket &packet, time_t ts, const char *unit, char *out, size_t size)
+{
+  char timeStr[6] = {0};
+  snprintf(timeStr, sizeof(timeStr), "%02d:%02d", packet.hours, packet.minutes);
 
-    return;
-  }
+  // fixed-point voltage, emitted as a JSON number without float math
+  char voltageStr[8] = {0};
+  XYParser::formatVoltage(packet.centivolts, voltageStr, sizeof(voltageStr));
 
-  // config parsing
-  StaticJsonDocument<256> doc;
-  doc["type"] = JsonTypeConfig;
+  StaticJsonDocument<192> doc;
+  doc["type"] = "data";
+  doc["voltage"] = serialized(voltageStr);
+  doc["percent"] = packet.percent;
+  doc["time"] = timeStr;
+  doc["state"] = packet.state;
   doc["device_id"] = MQTT_CLIENT_ID;
-  JsonObject params = doc.createNestedObject("params");
+  if (unit && unit[0])
+  {
+    doc["unit"] = unit;
+  }
+  if (ts && unixTimeValid(ts))
+  {
+    doc["ts"] = (uint32_t)ts;
+  }
+  else if (ts)
+  {
+    // stored before the first NTP answer: seconds since boot are no date
+    doc["ts_valid"] = false;
+  }
 
-  const char *knownKeys[] = {"dw", "up", "th", "st", "et", nullptr};
-  char buffer[64];
-  strncpy(buffer, rawLine, sizeof(buffer) - 1);
-  buffer[sizeof(buffer) - 1] = '\0';
+  return serializeJson(doc, out, size);
+}
+
+void handleXYResponse(XYChannel &ch, const char *rawLine)
+{
+  XYFrame frame;
 
-  char *token = strtok(buffer, ",");
-  bool hasAny = false;
+  // one pass: data packet, config echo or raw line
+  uint32_t decodeStart = ESP.getCycleCount();
+  XYFrameType type = XYParser::classify(rawLine, frame);
+  loopMetrics.recordDecode(ESP.getCycleCount() - decodeStart, strlen(rawLine));
 
-  while (token)
+  if (type == XY_FRAME_DATA)
   {
-    bool matched = false;
-    for (int i = 0; knownKeys[i]; ++i)
+    ch.lastDataLineUs = micros();
+    // every sample is kept on the device, even while MQTT is down
+    // (the history is the first unit's)
+    if (&ch == &xyChannels[0])
     {
-      size_t len = strlen(knownKeys[i]);
-      if (strncmp(token, knownKeys[i], len) == 0)
-      {
-        const char *value = token + len;
-        params[knownKeys[i]] = value;
-        matched = true;
-        hasAny = true;
-        break;
-      }
+      telemetryHistory.add(frame.packet, time(nullptr));
     }
 
-    if (!matched && strchr(token, ':') && strlen(token) <= 5)
+    // every sample goes live to open panels, the policy is for MQTT only
+    if (configServer.hasEventClients())
     {
-      params["timer"] = token;
-      hasAny = true;
+      char jsonBuffer[192] = {0};
+      buildXYPacketJson(frame.packet, 0, ch.unit, jsonBuffer, sizeof(jsonBuffer));
+      configServer.pushEvent("data", jsonBuffer);
     }
 
-    token = strtok(nullptr, ",");
+    // deadbands / coalescing window decide whether this sample goes out
+    // (to the outbox while MQTT is down)
+    if (ch.policy.offer(frame.packet, millis()))
+    {
+      publishXYPacket(ch, frame.packet);
+    }
+    return;
   }
 
-  if (hasAny)
+  // periodic data lines are never a command reply, everything else may be
+  ch.commands.onLine(rawLine);
+
+  if (!mqttClient.connected() && !configServer.hasEventClients())
   {
-    char jsonBufferConf[256] = {0};
-    char topic[32];
-    strncpy_P(topic, TOPIC_XY_CONFIG, sizeof(topic));
-    serializeJson(doc, jsonBufferConf, sizeof(jsonBufferConf));
-    mqttClient.publish(topic, jsonBufferConf);
+    return;
   }
-  else
+
+  char JsonTypeConfig[] = "config";
+  char JsonTypeRaw[] = "raw";
+
+  char jsonBuffer[256] = {0};
+  char topicBuf[MqttTopics::MAX_TOPIC_SIZE];
+  const char *topic = nullptr;
+
+  switch (type)
+  {
+  case XY_FRAME_CONFIG:
+  {
+    StaticJsonDocument<256> doc;
+    doc["type"] = JsonTypeConfig;
+    doc["device_id"] = MQTT_CLIENT_ID;
+    if (ch.named())
+    {
+      doc["unit"] = ch.unit;
+    }
+    JsonObject params = doc.createNestedObject("params");
+
+    for (uint8_t key = 0; key < XY_KEY_COUNT; ++key)
+    {
+      if (frame.config.mask & (1 << key))
+      {
+        params[XYParser::configKeyName((XYConfigKey)key)] = (const char *)frame.config.values[key];
+      }
+    }
+
+    serializeJson(doc, jsonBuffer, sizeof(jsonBuffer));
+    topic = unitTopic(MQTT_TOPIC_CONFIG, ch, topicBuf, sizeof(topicBuf));
+    configServer.pushEvent("config", jsonBuffer);
+    break;
+  }
+  default:
   {
-    StaticJsonDocument<128> rawDoc;
+    StaticJsonDocument<192> rawDoc;
     rawDoc["type"] = JsonTypeRaw;
     rawDoc["line"] = rawLine;
     rawDoc["device_id"] = MQTT_CLIENT_ID;
-    char jsonBufferRaw[256] = {0};
-    serializeJson(rawDoc, jsonBufferRaw, sizeof(jsonBufferRaw));
-    char topic[32];
-    strncpy_P(topic, TOPIC_XY_RAW, sizeof(topic));
-    mqttClient.publish(topic, jsonBufferRaw);
+    if (ch.named())
+    {
+      rawDoc["unit"] = ch.unit;
+    }
+
+    serializeJson(rawDoc, jsonBuffer, sizeof(jsonBuffer));
+    topic = unitTopic(MQTT_TOPIC_RAW, ch, topicBuf, sizeof(topicBuf));
+    configServer.pushEvent("raw", jsonBuffer);
+    break;
+  }
+  }
+
+  if (mqttClient.connected())
+  {
+    mqttClient.publish(topic, jsonBuffer);
   }
 }